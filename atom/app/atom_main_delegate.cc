@@ -14,6 +14,7 @@
 
 #include "atom/app/atom_content_client.h"
 #include "atom/browser/atom_browser_client.h"
+#include "atom/browser/early_process_singleton.h"
 #include "atom/browser/relauncher.h"
 #include "atom/common/options_switches.h"
 #include "atom/renderer/atom_renderer_client.h"
@@ -186,6 +187,14 @@ bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
   content_client_ = std::make_unique<AtomContentClient>();
   SetContentClient(content_client_.get());
 
+  // A second instance only has to hand its command line over, there is no
+  // need to start the browser for that.
+  if (IsBrowserProcess(command_line) &&
+      !AcquireEarlySingleInstanceLock(*command_line)) {
+    *exit_code = 0;
+    return true;
+  }
+
   return false;
 }
 
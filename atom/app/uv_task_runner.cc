@@ -2,32 +2,57 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <utility>
 
 #include "atom/app/uv_task_runner.h"
 
-#include "base/stl_util.h"
-
 namespace atom {
 
-UvTaskRunner::UvTaskRunner(uv_loop_t* loop) : loop_(loop) {}
+UvTaskRunner::PendingTask::PendingTask(base::OnceClosure task,
+                                       bool nestable,
+                                       base::TimeTicks run_time,
+                                       uint64_t sequence_num)
+    : task(std::move(task)),
+      nestable(nestable),
+      run_time(run_time),
+      sequence_num(sequence_num) {}
+
+UvTaskRunner::PendingTask::PendingTask(PendingTask&& other) noexcept = default;
+
+UvTaskRunner::PendingTask::~PendingTask() = default;
+
+UvTaskRunner::PendingTask& UvTaskRunner::PendingTask::operator=(
+    PendingTask&& other) noexcept = default;
+
+bool UvTaskRunner::PendingTask::operator<(const PendingTask& other) const {
+  // std::push_heap keeps the greatest element on top, so the comparison is
+  // reversed to keep the earliest task there, with ties broken by post order.
+  if (run_time != other.run_time)
+    return run_time > other.run_time;
+  return sequence_num > other.sequence_num;
+}
+
+UvTaskRunner::UvTaskRunner(uv_loop_t* loop)
+    : loop_(loop), async_(new uv_async_t), timer_(new uv_timer_t) {
+  async_->data = this;
+  uv_async_init(loop_, async_, UvTaskRunner::OnAsync);
+  // The async handle only keeps the loop alive while there are tasks.
+  uv_unref(reinterpret_cast<uv_handle_t*>(async_));
+
+  timer_->data = this;
+  uv_timer_init(loop_, timer_);
+}
 
 UvTaskRunner::~UvTaskRunner() {
-  for (auto& iter : tasks_) {
-    uv_unref(reinterpret_cast<uv_handle_t*>(iter.first));
-    delete iter.first;
-  }
+  uv_close(reinterpret_cast<uv_handle_t*>(async_), UvTaskRunner::OnClose);
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), UvTaskRunner::OnClose);
 }
 
 bool UvTaskRunner::PostDelayedTask(const base::Location& from_here,
                                    base::OnceClosure task,
                                    base::TimeDelta delay) {
-  auto* timer = new uv_timer_t;
-  timer->data = this;
-  uv_timer_init(loop_, timer);
-  uv_timer_start(timer, UvTaskRunner::OnTimeout, delay.InMilliseconds(), 0);
-  tasks_[timer] = std::move(task);
-  return true;
+  return PostTask(std::move(task), delay, true);
 }
 
 bool UvTaskRunner::RunsTasksInCurrentSequence() const {
@@ -37,24 +62,105 @@ bool UvTaskRunner::RunsTasksInCurrentSequence() const {
 bool UvTaskRunner::PostNonNestableDelayedTask(const base::Location& from_here,
                                               base::OnceClosure task,
                                               base::TimeDelta delay) {
-  return PostDelayedTask(from_here, std::move(task), delay);
+  return PostTask(std::move(task), delay, false);
 }
 
-// static
-void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
-  UvTaskRunner* self = static_cast<UvTaskRunner*>(timer->data);
-  if (!ContainsKey(self->tasks_, timer))
+bool UvTaskRunner::PostTask(base::OnceClosure task,
+                            base::TimeDelta delay,
+                            bool nestable) {
+  if (delay <= base::TimeDelta()) {
+    EnqueueImmediateTask(PendingTask(std::move(task), nestable,
+                                     base::TimeTicks(), next_sequence_num_++));
+    return true;
+  }
+
+  delayed_tasks_.emplace_back(std::move(task), nestable,
+                              base::TimeTicks::Now() + delay,
+                              next_sequence_num_++);
+  std::push_heap(delayed_tasks_.begin(), delayed_tasks_.end());
+  // Only re-arm the timer when the new task is the earliest one.
+  if (delayed_tasks_.front().sequence_num == next_sequence_num_ - 1)
+    ScheduleTimer();
+  return true;
+}
+
+void UvTaskRunner::EnqueueImmediateTask(PendingTask task) {
+  if (immediate_tasks_.empty()) {
+    uv_ref(reinterpret_cast<uv_handle_t*>(async_));
+    uv_async_send(async_);
+  }
+  immediate_tasks_.push_back(std::move(task));
+}
+
+void UvTaskRunner::RunTask(PendingTask task) {
+  if (!task.nestable && nesting_depth_ > 0) {
+    deferred_tasks_.push_back(std::move(task));
     return;
+  }
+
+  ++nesting_depth_;
+  std::move(task.task).Run();
+  --nesting_depth_;
+
+  // Back in the outermost task, the deferred tasks can run now.
+  if (nesting_depth_ == 0) {
+    while (!deferred_tasks_.empty()) {
+      EnqueueImmediateTask(std::move(deferred_tasks_.front()));
+      deferred_tasks_.pop_front();
+    }
+  }
+}
+
+void UvTaskRunner::RunImmediateTasks() {
+  // Only run the tasks that are already queued, tasks posted meanwhile wait
+  // for the next iteration so they can not starve uv's I/O.
+  base::circular_deque<PendingTask> tasks;
+  tasks.swap(immediate_tasks_);
+  uv_unref(reinterpret_cast<uv_handle_t*>(async_));
+
+  for (auto& task : tasks)
+    RunTask(std::move(task));
+}
+
+void UvTaskRunner::RunDelayedTasks() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  while (!delayed_tasks_.empty() && delayed_tasks_.front().run_time <= now) {
+    std::pop_heap(delayed_tasks_.begin(), delayed_tasks_.end());
+    PendingTask task = std::move(delayed_tasks_.back());
+    delayed_tasks_.pop_back();
+    RunTask(std::move(task));
+  }
+  ScheduleTimer();
+}
 
-  std::move(self->tasks_[timer]).Run();
-  self->tasks_.erase(timer);
-  uv_timer_stop(timer);
-  uv_close(reinterpret_cast<uv_handle_t*>(timer), UvTaskRunner::OnClose);
+void UvTaskRunner::ScheduleTimer() {
+  if (delayed_tasks_.empty()) {
+    uv_timer_stop(timer_);
+    return;
+  }
+
+  base::TimeDelta delay =
+      delayed_tasks_.front().run_time - base::TimeTicks::Now();
+  uv_timer_start(timer_, UvTaskRunner::OnTimeout,
+                 std::max<int64_t>(delay.InMillisecondsRoundedUp(), 0), 0);
+}
+
+// static
+void UvTaskRunner::OnAsync(uv_async_t* handle) {
+  static_cast<UvTaskRunner*>(handle->data)->RunImmediateTasks();
+}
+
+// static
+void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
+  static_cast<UvTaskRunner*>(timer->data)->RunDelayedTasks();
 }
 
 // static
 void UvTaskRunner::OnClose(uv_handle_t* handle) {
-  delete reinterpret_cast<uv_timer_t*>(handle);
+  if (handle->type == UV_ASYNC)
+    delete reinterpret_cast<uv_async_t*>(handle);
+  else
+    delete reinterpret_cast<uv_timer_t*>(handle);
 }
 
 }  // namespace atom
@@ -5,16 +5,22 @@
 #ifndef ATOM_APP_UV_TASK_RUNNER_H_
 #define ATOM_APP_UV_TASK_RUNNER_H_
 
-#include <map>
+#include <vector>
 
 #include "base/callback.h"
+#include "base/containers/circular_deque.h"
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
+#include "base/time/time.h"
 #include "uv.h"  // NOLINT(build/include)
 
 namespace atom {
 
 // TaskRunner implementation that posts tasks into libuv's default loop.
+//
+// Immediate tasks are kept in a FIFO queue drained by a single uv_async_t, and
+// delayed tasks in a min-heap driven by a single uv_timer_t that is re-armed
+// for the earliest one.
 class UvTaskRunner : public base::SingleThreadTaskRunner {
  public:
   explicit UvTaskRunner(uv_loop_t* loop);
@@ -29,13 +35,57 @@ class UvTaskRunner : public base::SingleThreadTaskRunner {
                                   base::TimeDelta delay) override;
 
  private:
+  struct PendingTask {
+    PendingTask(base::OnceClosure task,
+                bool nestable,
+                base::TimeTicks run_time,
+                uint64_t sequence_num);
+    PendingTask(PendingTask&& other) noexcept;
+    ~PendingTask();
+
+    PendingTask& operator=(PendingTask&& other) noexcept;
+
+    // Orders the delayed tasks heap so the earliest task is on top.
+    bool operator<(const PendingTask& other) const;
+
+    base::OnceClosure task;
+    bool nestable;
+    base::TimeTicks run_time;
+    uint64_t sequence_num;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(PendingTask);
+  };
+
   ~UvTaskRunner() override;
+
+  bool PostTask(base::OnceClosure task, base::TimeDelta delay, bool nestable);
+
+  // Adds |task| to the immediate tasks and wakes up the loop if needed.
+  void EnqueueImmediateTask(PendingTask task);
+
+  void RunTask(PendingTask task);
+  void RunImmediateTasks();
+  void RunDelayedTasks();
+
+  // Arms the timer for the earliest delayed task.
+  void ScheduleTimer();
+
+  static void OnAsync(uv_async_t* handle);
   static void OnTimeout(uv_timer_t* timer);
   static void OnClose(uv_handle_t* handle);
 
   uv_loop_t* loop_;
+  uv_async_t* async_;
+  uv_timer_t* timer_;
+
+  base::circular_deque<PendingTask> immediate_tasks_;
+  std::vector<PendingTask> delayed_tasks_;
+  // Non-nestable tasks which came up while running another task.
+  base::circular_deque<PendingTask> deferred_tasks_;
 
-  std::map<uv_timer_t*, base::OnceClosure> tasks_;
+  uint64_t next_sequence_num_ = 0;
+  int nesting_depth_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(UvTaskRunner);
 };
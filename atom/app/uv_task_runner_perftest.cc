@@ -0,0 +1,110 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/app/uv_task_runner.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace atom {
+
+namespace {
+
+const int kTasks = 100000;
+
+class UvTaskRunnerPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(0, uv_loop_init(&loop_));
+    task_runner_ = new UvTaskRunner(&loop_);
+  }
+
+  void TearDown() override {
+    // Let the loop run the close callbacks of the runner's handles.
+    task_runner_ = nullptr;
+    uv_run(&loop_, UV_RUN_DEFAULT);
+    EXPECT_EQ(0, uv_loop_close(&loop_));
+  }
+
+  void PostChainedTask(int* remaining) {
+    if (--*remaining > 0) {
+      task_runner_->PostTask(
+          FROM_HERE, base::BindOnce(&UvTaskRunnerPerfTest::PostChainedTask,
+                                    base::Unretained(this), remaining));
+    }
+  }
+
+  uv_loop_t loop_;
+  scoped_refptr<UvTaskRunner> task_runner_;
+};
+
+}  // namespace
+
+// Tasks posted up front, drained by as few loop iterations as possible.
+TEST_F(UvTaskRunnerPerfTest, PostedTasks) {
+  int run = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kTasks; ++i)
+    task_runner_->PostTask(FROM_HERE,
+                           base::BindOnce([](int* run) { ++*run; }, &run));
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(kTasks, run);
+  perf_test::PrintResult("uv_task_runner", "_posted_tasks", "100k_tasks",
+                         kTasks / elapsed.InSecondsF(), "tasks/s", true);
+}
+
+// Non-nestable tasks take the same queue, but are checked against the nesting
+// depth when they run.
+TEST_F(UvTaskRunnerPerfTest, NonNestableTasks) {
+  int run = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kTasks; ++i) {
+    task_runner_->PostNonNestableTask(
+        FROM_HERE, base::BindOnce([](int* run) { ++*run; }, &run));
+  }
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(kTasks, run);
+  perf_test::PrintResult("uv_task_runner", "_non_nestable_tasks", "100k_tasks",
+                         kTasks / elapsed.InSecondsF(), "tasks/s", true);
+}
+
+// Every task posts the next one, so each one costs a loop iteration.
+TEST_F(UvTaskRunnerPerfTest, ChainedTasks) {
+  int remaining = kTasks;
+  base::TimeTicks start = base::TimeTicks::Now();
+  PostChainedTask(&remaining);
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(0, remaining);
+  perf_test::PrintResult("uv_task_runner", "_chained_tasks", "100k_tasks",
+                         kTasks / elapsed.InSecondsF(), "tasks/s", true);
+}
+
+// Delayed tasks posted in reverse order, exercising the timer heap.
+TEST_F(UvTaskRunnerPerfTest, DelayedTasks) {
+  const int kDelayedTasks = 10000;
+  int run = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = kDelayedTasks; i > 0; --i) {
+    task_runner_->PostDelayedTask(
+        FROM_HERE, base::BindOnce([](int* run) { ++*run; }, &run),
+        base::TimeDelta::FromMicroseconds(i));
+  }
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(kDelayedTasks, run);
+  perf_test::PrintResult("uv_task_runner", "_delayed_tasks", "10k_tasks",
+                         kDelayedTasks / elapsed.InSecondsF(), "tasks/s", true);
+}
+
+}  // namespace atom
@@ -14,6 +14,7 @@
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/atom_paths.h"
+#include "atom/browser/early_process_singleton.h"
 #include "atom/browser/login_handler.h"
 #include "atom/browser/relauncher.h"
 #include "atom/common/atom_command_line.h"
@@ -554,6 +555,12 @@ App::App(v8::Isolate* isolate) {
       content::PROCESS_TYPE_BROWSER, pid,
       base::ProcessMetrics::CreateCurrentProcessMetrics());
   app_metrics_[pid] = std::move(process_metric);
+
+  // Adopt the lock if it was taken before the browser was initialized.
+  auto cb = base::Bind(&App::OnSecondInstance, base::Unretained(this));
+  process_singleton_ = TakeEarlySingleInstanceLock(
+      base::Bind(NotificationCallbackWrapper, cb));
+
   Init(isolate);
 }
 
@@ -4,14 +4,21 @@
 
 #include "atom/browser/api/atom_api_cookies.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/cookie_change_notifier.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/time/time.h"
 #include "base/values.h"
@@ -83,6 +90,19 @@ struct Converter<network::mojom::CookieChangeCause> {
   }
 };
 
+template <>
+struct Converter<atom::api::Cookies::CookieChange> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const atom::api::Cookies::CookieChange& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("cookie", val.cookie);
+    dict.Set("cause", val.cause);
+    dict.Set("removed", val.removed);
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -91,41 +111,63 @@ namespace api {
 
 namespace {
 
-// Returns whether |domain| matches |filter|.
-bool MatchesDomain(std::string filter, const std::string& domain) {
-  // Add a leading '.' character to the filter domain if it doesn't exist.
-  if (net::cookie_util::DomainIsHostOnly(filter))
-    filter.insert(0, ".");
+// The fields of a cookies.get() filter, parsed once instead of being looked
+// up in the filter dictionary for every cookie.
+struct CookieFilter {
+  std::string url;
+  base::Optional<std::string> name;
+  base::Optional<std::string> path;
+  // Always starts with a '.'.
+  base::Optional<std::string> domain;
+  base::Optional<bool> secure;
+  base::Optional<bool> session;
+
+  explicit CookieFilter(const base::DictionaryValue& filter) {
+    std::string str;
+    bool b;
+    filter.GetString("url", &url);
+    if (filter.GetString("name", &str))
+      name = str;
+    if (filter.GetString("path", &str))
+      path = str;
+    if (filter.GetString("domain", &str)) {
+      // Add a leading '.' character to the filter domain if it doesn't exist.
+      if (net::cookie_util::DomainIsHostOnly(str))
+        str.insert(0, ".");
+      domain = str;
+    }
+    if (filter.GetBoolean("secure", &b))
+      secure = b;
+    if (filter.GetBoolean("session", &b))
+      session = b;
+  }
+};
 
-  std::string sub_domain(domain);
+// Returns whether |domain| is |filter| or a subdomain of it, |filter| must
+// start with a '.'.
+bool MatchesDomain(const std::string& filter, base::StringPiece domain) {
   // Strip any leading '.' character from the input cookie domain.
-  if (!net::cookie_util::DomainIsHostOnly(sub_domain))
-    sub_domain = sub_domain.substr(1);
+  if (!domain.empty() && domain[0] == '.')
+    domain.remove_prefix(1);
 
-  // Now check whether the domain argument is a subdomain of the filter domain.
-  for (sub_domain.insert(0, "."); sub_domain.length() >= filter.length();) {
-    if (sub_domain == filter)
-      return true;
-    const size_t next_dot = sub_domain.find('.', 1);  // Skip over leading dot.
-    sub_domain.erase(0, next_dot);
-  }
-  return false;
+  if (domain.size() + 1 == filter.size())
+    return base::StringPiece(filter).substr(1) == domain;
+  return domain.size() > filter.size() &&
+         base::EndsWith(domain, filter, base::CompareCase::SENSITIVE);
 }
 
-// Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
+// Returns whether |cookie| matches |filter|, cheapest checks first.
+bool MatchesCookie(const CookieFilter& filter,
                    const net::CanonicalCookie& cookie) {
-  std::string str;
-  bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
+  if (filter.name && *filter.name != cookie.Name())
     return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
+  if (filter.secure && *filter.secure != cookie.IsSecure())
     return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
+  if (filter.session && *filter.session != !cookie.IsPersistent())
     return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
+  if (filter.path && *filter.path != cookie.Path())
     return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
+  if (filter.domain && !MatchesDomain(*filter.domain, cookie.Domain()))
     return false;
   return true;
 }
@@ -157,26 +199,26 @@ void RunCallbackInUI(const base::Closure& callback) {
 }
 
 // Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
+void FilterCookies(std::unique_ptr<CookieFilter> filter,
                    scoped_refptr<util::Promise> promise,
                    const net::CookieList& list) {
   net::CookieList result;
   for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
+    if (MatchesCookie(*filter, cookie))
       result.push_back(cookie);
   }
 
   base::PostTaskWithTraits(
       FROM_HERE, {BrowserThread::UI},
-      base::BindOnce(ResolvePromiseWithCookies, std::move(promise), result));
+      base::BindOnce(ResolvePromiseWithCookies, std::move(promise),
+                     std::move(result)));
 }
 
 // Receives cookies matching |filter| in IO thread.
 void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
+                    std::unique_ptr<CookieFilter> filter,
                     scoped_refptr<util::Promise> promise) {
-  std::string url;
-  filter->GetString("url", &url);
+  std::string url = filter->url;
 
   auto filtered_callback =
       base::Bind(FilterCookies, base::Passed(&filter), std::move(promise));
@@ -222,40 +264,41 @@ void FlushCookieStoreOnIOThread(
       base::BindOnce(ResolvePromiseInUI, std::move(promise)));
 }
 
-// Sets cookie with |details| in IO thread.
-void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                   std::unique_ptr<base::DictionaryValue> details,
-                   scoped_refptr<util::Promise> promise) {
+// Sets cookie with |details| in IO thread, |callback| is called with whether
+// the cookie was set.
+void SetCookieWithDetails(net::CookieStore* cookie_store,
+                          const base::DictionaryValue& details,
+                          base::OnceCallback<void(bool)> callback) {
   std::string url, name, value, domain, path;
   bool secure = false;
   bool http_only = false;
   double creation_date;
   double expiration_date;
   double last_access_date;
-  details->GetString("url", &url);
-  details->GetString("name", &name);
-  details->GetString("value", &value);
-  details->GetString("domain", &domain);
-  details->GetString("path", &path);
-  details->GetBoolean("secure", &secure);
-  details->GetBoolean("httpOnly", &http_only);
+  details.GetString("url", &url);
+  details.GetString("name", &name);
+  details.GetString("value", &value);
+  details.GetString("domain", &domain);
+  details.GetString("path", &path);
+  details.GetBoolean("secure", &secure);
+  details.GetBoolean("httpOnly", &http_only);
 
   base::Time creation_time;
-  if (details->GetDouble("creationDate", &creation_date)) {
+  if (details.GetDouble("creationDate", &creation_date)) {
     creation_time = (creation_date == 0)
                         ? base::Time::UnixEpoch()
                         : base::Time::FromDoubleT(creation_date);
   }
 
   base::Time expiration_time;
-  if (details->GetDouble("expirationDate", &expiration_date)) {
+  if (details.GetDouble("expirationDate", &expiration_date)) {
     expiration_time = (expiration_date == 0)
                           ? base::Time::UnixEpoch()
                           : base::Time::FromDoubleT(expiration_date);
   }
 
   base::Time last_access_time;
-  if (details->GetDouble("lastAccessDate", &last_access_date)) {
+  if (details.GetDouble("lastAccessDate", &last_access_date)) {
     last_access_time = (last_access_date == 0)
                            ? base::Time::UnixEpoch()
                            : base::Time::FromDoubleT(last_access_date);
@@ -266,22 +309,87 @@ void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
           GURL(url), name, value, domain, path, creation_time, expiration_time,
           last_access_time, secure, http_only,
           net::CookieSameSite::DEFAULT_MODE, net::COOKIE_PRIORITY_DEFAULT));
-  auto completion_callback = base::BindOnce(OnSetCookie, std::move(promise));
   if (!canonical_cookie || !canonical_cookie->IsCanonical()) {
-    std::move(completion_callback).Run(false);
+    std::move(callback).Run(false);
     return;
   }
   if (url.empty()) {
-    std::move(completion_callback).Run(false);
+    std::move(callback).Run(false);
     return;
   }
   if (name.empty()) {
-    std::move(completion_callback).Run(false);
+    std::move(callback).Run(false);
     return;
   }
-  GetCookieStore(getter)->SetCanonicalCookieAsync(
-      std::move(canonical_cookie), secure, http_only,
-      std::move(completion_callback));
+  cookie_store->SetCanonicalCookieAsync(std::move(canonical_cookie), secure,
+                                        http_only, std::move(callback));
+}
+
+// Sets cookie with |details| in IO thread.
+void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                   std::unique_ptr<base::DictionaryValue> details,
+                   scoped_refptr<util::Promise> promise) {
+  SetCookieWithDetails(GetCookieStore(getter), *details,
+                       base::BindOnce(OnSetCookie, std::move(promise)));
+}
+
+// Collects the results of a batch of cookie changes in IO thread, and settles
+// the promise once the last change has completed and released the batch.
+class CookieBatch : public base::RefCountedThreadSafe<CookieBatch> {
+ public:
+  explicit CookieBatch(scoped_refptr<util::Promise> promise)
+      : promise_(std::move(promise)) {}
+
+  void OnChangeDone(bool success) {
+    if (!success)
+      ++failures_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<CookieBatch>;
+
+  ~CookieBatch() {
+    std::string errmsg;
+    if (failures_ > 0)
+      errmsg = base::StringPrintf("Setting %zu cookie(s) failed", failures_);
+    RunCallbackInUI(base::Bind(SettlePromiseInUI, std::move(promise_), errmsg));
+  }
+
+  scoped_refptr<util::Promise> promise_;
+  size_t failures_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieBatch);
+};
+
+// Sets all cookies in |details_list| in IO thread.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    std::unique_ptr<base::ListValue> details_list,
+                    scoped_refptr<util::Promise> promise) {
+  auto batch = base::MakeRefCounted<CookieBatch>(std::move(promise));
+  auto* cookie_store = GetCookieStore(getter);
+  for (const auto& value : details_list->GetList()) {
+    const base::DictionaryValue* details = nullptr;
+    if (!value.GetAsDictionary(&details)) {
+      batch->OnChangeDone(false);
+      continue;
+    }
+    SetCookieWithDetails(cookie_store, *details,
+                         base::BindOnce(&CookieBatch::OnChangeDone, batch));
+  }
+}
+
+// Removes all cookies in |cookies|, given as (url, name) pairs, in IO thread.
+void RemoveCookiesOnIO(
+    scoped_refptr<net::URLRequestContextGetter> getter,
+    std::vector<std::pair<GURL, std::string>> cookies,
+    scoped_refptr<util::Promise> promise) {
+  auto batch = base::MakeRefCounted<CookieBatch>(std::move(promise));
+  auto* cookie_store = GetCookieStore(getter);
+  for (const auto& cookie : cookies) {
+    cookie_store->DeleteCookieAsync(
+        cookie.first, cookie.second,
+        base::BindOnce(&CookieBatch::OnChangeDone, batch, true));
+  }
 }
 
 }  // namespace
@@ -299,13 +407,11 @@ Cookies::~Cookies() {}
 v8::Local<v8::Promise> Cookies::Get(const base::DictionaryValue& filter) {
   scoped_refptr<util::Promise> promise = new util::Promise(isolate());
 
-  auto copy = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(filter.Clone()));
   auto* getter = browser_context_->GetRequestContext();
   base::PostTaskWithTraits(
       FROM_HERE, {BrowserThread::IO},
-      base::BindOnce(GetCookiesOnIO, base::RetainedRef(getter), std::move(copy),
-                     promise));
+      base::BindOnce(GetCookiesOnIO, base::RetainedRef(getter),
+                     std::make_unique<CookieFilter>(filter), promise));
 
   return promise->GetHandle();
 }
@@ -337,6 +443,45 @@ v8::Local<v8::Promise> Cookies::Set(const base::DictionaryValue& details) {
   return promise->GetHandle();
 }
 
+v8::Local<v8::Promise> Cookies::SetMany(const base::ListValue& details_list) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate());
+
+  auto copy = base::ListValue::From(
+      base::Value::ToUniquePtrValue(details_list.Clone()));
+  auto* getter = browser_context_->GetRequestContext();
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(SetCookiesOnIO, base::RetainedRef(getter), std::move(copy),
+                     promise));
+
+  return promise->GetHandle();
+}
+
+v8::Local<v8::Promise> Cookies::RemoveMany(
+    const std::vector<mate::Dictionary>& cookies) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate());
+
+  std::vector<std::pair<GURL, std::string>> pairs;
+  pairs.reserve(cookies.size());
+  for (const auto& cookie : cookies) {
+    GURL url;
+    std::string name;
+    if (!cookie.Get("url", &url) || !cookie.Get("name", &name)) {
+      promise->RejectWithErrorMessage("Each cookie must have a url and name");
+      return promise->GetHandle();
+    }
+    pairs.emplace_back(url, name);
+  }
+
+  auto* getter = browser_context_->GetRequestContext();
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(RemoveCookiesOnIO, base::RetainedRef(getter),
+                     std::move(pairs), promise));
+
+  return promise->GetHandle();
+}
+
 v8::Local<v8::Promise> Cookies::FlushStore() {
   scoped_refptr<util::Promise> promise = new util::Promise(isolate());
 
@@ -348,8 +493,69 @@ v8::Local<v8::Promise> Cookies::FlushStore() {
   return promise->GetHandle();
 }
 
+void Cookies::SetChangeNotificationOptions(const mate::Dictionary& options) {
+  std::vector<std::string> domains;
+  options.Get("domains", &domains);
+  change_domains_.clear();
+  for (auto& domain : domains) {
+    if (net::cookie_util::DomainIsHostOnly(domain))
+      domain.insert(0, ".");
+    change_domains_.push_back(std::move(domain));
+  }
+
+  std::vector<std::string> names;
+  options.Get("names", &names);
+  change_names_ = base::flat_set<std::string>(std::move(names));
+
+  int interval = 0;
+  options.Get("batchInterval", &interval);
+  batch_interval_ = base::TimeDelta::FromMilliseconds(std::max(interval, 0));
+
+  bool batch = false;
+  options.Get("batch", &batch);
+  if (batch_changes_ && !batch) {
+    // Do not hold back the changes gathered so far.
+    batch_timer_.Stop();
+    EmitPendingChanges();
+  }
+  batch_changes_ = batch;
+}
+
 void Cookies::OnCookieChanged(const CookieDetails* details) {
-  Emit("changed", *(details->cookie), details->cause, details->removed);
+  if (!MatchesChangeFilter(*details->cookie))
+    return;
+
+  if (!batch_changes_) {
+    Emit("changed", *(details->cookie), details->cause, details->removed);
+    return;
+  }
+
+  pending_changes_.push_back(
+      {*details->cookie, details->cause, details->removed});
+  if (!batch_timer_.IsRunning())
+    batch_timer_.Start(FROM_HERE, batch_interval_,
+                       base::BindOnce(&Cookies::EmitPendingChanges,
+                                      base::Unretained(this)));
+}
+
+bool Cookies::MatchesChangeFilter(const net::CanonicalCookie& cookie) const {
+  if (!change_names_.empty() && !change_names_.count(cookie.Name()))
+    return false;
+  if (change_domains_.empty())
+    return true;
+  for (const auto& domain : change_domains_) {
+    if (MatchesDomain(domain, cookie.Domain()))
+      return true;
+  }
+  return false;
+}
+
+void Cookies::EmitPendingChanges() {
+  if (pending_changes_.empty())
+    return;
+  std::vector<CookieChange> changes;
+  changes.swap(pending_changes_);
+  Emit("changes", changes);
 }
 
 // static
@@ -366,7 +572,11 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
-      .SetMethod("flushStore", &Cookies::FlushStore);
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("flushStore", &Cookies::FlushStore)
+      .SetMethod("setChangeNotificationOptions",
+                 &Cookies::SetChangeNotificationOptions);
 }
 
 }  // namespace api
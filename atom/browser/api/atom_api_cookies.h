@@ -7,16 +7,22 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/net/cookie_details.h"
 #include "atom/common/promise_util.h"
 #include "base/callback_list.h"
+#include "base/containers/flat_set.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "native_mate/dictionary.h"
 #include "native_mate/handle.h"
 #include "net/cookies/canonical_cookie.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace net {
@@ -36,6 +42,13 @@ class Cookies : public mate::TrackableObject<Cookies> {
     FAILED,
   };
 
+  // A change delivered by the "changes" event.
+  struct CookieChange {
+    net::CanonicalCookie cookie;
+    network::mojom::CookieChangeCause cause;
+    bool removed;
+  };
+
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
 
@@ -50,16 +63,36 @@ class Cookies : public mate::TrackableObject<Cookies> {
   v8::Local<v8::Promise> Get(const base::DictionaryValue& filter);
   v8::Local<v8::Promise> Set(const base::DictionaryValue& details);
   v8::Local<v8::Promise> Remove(const GURL& url, const std::string& name);
+  v8::Local<v8::Promise> SetMany(const base::ListValue& details_list);
+  v8::Local<v8::Promise> RemoveMany(
+      const std::vector<mate::Dictionary>& cookies);
   v8::Local<v8::Promise> FlushStore();
+  void SetChangeNotificationOptions(const mate::Dictionary& options);
 
   // CookieChangeNotifier subscription:
   void OnCookieChanged(const CookieDetails*);
 
  private:
+  bool MatchesChangeFilter(const net::CanonicalCookie& cookie) const;
+  void EmitPendingChanges();
+
   std::unique_ptr<base::CallbackList<void(const CookieDetails*)>::Subscription>
       cookie_change_subscription_;
   scoped_refptr<AtomBrowserContext> browser_context_;
 
+  // Only the changes to cookies of these domains and names are emitted, when
+  // the sets are not empty. The domains always start with a '.'.
+  std::vector<std::string> change_domains_;
+  base::flat_set<std::string> change_names_;
+
+  // When |batch_changes_| is set, the changes are gathered for
+  // |batch_interval_| and emitted at once with the "changes" event. A zero
+  // interval gathers them until the end of the current task.
+  bool batch_changes_ = false;
+  base::TimeDelta batch_interval_;
+  base::OneShotTimer batch_timer_;
+  std::vector<CookieChange> pending_changes_;
+
   DISALLOW_COPY_AND_ASSIGN(Cookies);
 };
 
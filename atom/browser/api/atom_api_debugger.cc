@@ -7,11 +7,16 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "content/public/browser/devtools_agent_host.h"
 #include "content/public/browser/web_contents.h"
 #include "native_mate/dictionary.h"
@@ -24,6 +29,159 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// The members of a protocol message needed to route it. The values point into
+// the message and are left serialized.
+struct ProtocolMessage {
+  bool has_id = false;
+  int id = 0;
+  base::StringPiece method;
+  base::StringPiece params;
+  base::StringPiece result;
+  base::StringPiece error;
+};
+
+// Walks the top level of a protocol message without building a value tree,
+// nested values are only skipped over.
+class ProtocolMessageScanner {
+ public:
+  explicit ProtocolMessageScanner(base::StringPiece json) : json_(json) {}
+
+  bool Scan(ProtocolMessage* message) {
+    SkipWhitespace();
+    if (!Consume('{'))
+      return false;
+    SkipWhitespace();
+    if (Consume('}'))
+      return true;
+
+    while (true) {
+      base::StringPiece key;
+      SkipWhitespace();
+      if (!ScanString(&key))
+        return false;
+      SkipWhitespace();
+      if (!Consume(':'))
+        return false;
+      SkipWhitespace();
+
+      if (key == "id") {
+        if (!ScanInteger(&message->id))
+          return false;
+        message->has_id = true;
+      } else if (key == "method") {
+        if (!ScanString(&message->method))
+          return false;
+      } else {
+        size_t start = pos_;
+        if (!SkipValue())
+          return false;
+        base::StringPiece value = json_.substr(start, pos_ - start);
+        if (key == "params")
+          message->params = value;
+        else if (key == "result")
+          message->result = value;
+        else if (key == "error")
+          message->error = value;
+      }
+
+      SkipWhitespace();
+      if (!Consume(','))
+        return Consume('}');
+    }
+  }
+
+  // Whether the whole input is a single object, its members are not checked.
+  bool ScanObject() {
+    SkipWhitespace();
+    if (pos_ >= json_.size() || json_[pos_] != '{' || !SkipValue())
+      return false;
+    SkipWhitespace();
+    return pos_ == json_.size();
+  }
+
+ private:
+  void SkipWhitespace() {
+    while (pos_ < json_.size() && base::IsAsciiWhitespace(json_[pos_]))
+      ++pos_;
+  }
+
+  bool Consume(char c) {
+    if (pos_ >= json_.size() || json_[pos_] != c)
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  // Stores the contents of the string, still escaped, in |out|.
+  bool ScanString(base::StringPiece* out) {
+    if (!Consume('"'))
+      return false;
+    size_t start = pos_;
+    while (pos_ < json_.size()) {
+      char c = json_[pos_];
+      if (c == '"') {
+        if (out)
+          *out = json_.substr(start, pos_ - start);
+        ++pos_;
+        return true;
+      }
+      pos_ += c == '\\' ? 2 : 1;
+    }
+    return false;
+  }
+
+  bool ScanInteger(int* out) {
+    size_t start = pos_;
+    if (pos_ < json_.size() && json_[pos_] == '-')
+      ++pos_;
+    while (pos_ < json_.size() && base::IsAsciiDigit(json_[pos_]))
+      ++pos_;
+    return base::StringToInt(json_.substr(start, pos_ - start), out);
+  }
+
+  bool SkipValue() {
+    if (pos_ >= json_.size())
+      return false;
+    char c = json_[pos_];
+    if (c == '"')
+      return ScanString(nullptr);
+    if (c != '{' && c != '[') {
+      // Numbers, true, false and null.
+      while (pos_ < json_.size() && json_[pos_] != ',' && json_[pos_] != '}' &&
+             json_[pos_] != ']' && !base::IsAsciiWhitespace(json_[pos_]))
+        ++pos_;
+      return true;
+    }
+
+    int depth = 0;
+    do {
+      if (pos_ >= json_.size())
+        return false;
+      c = json_[pos_];
+      if (c == '"') {
+        if (!ScanString(nullptr))
+          return false;
+        continue;
+      }
+      if (c == '{' || c == '[')
+        ++depth;
+      else if (c == '}' || c == ']')
+        --depth;
+      ++pos_;
+    } while (depth > 0);
+    return true;
+  }
+
+  base::StringPiece json_;
+  size_t pos_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolMessageScanner);
+};
+
+}  // namespace
+
 Debugger::Debugger(v8::Isolate* isolate, content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents), web_contents_(web_contents) {
   Init(isolate);
@@ -42,44 +200,39 @@ void Debugger::DispatchProtocolMessage(DevToolsAgentHost* agent_host,
                                        const std::string& message) {
   DCHECK(agent_host == agent_host_);
 
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-
-  std::unique_ptr<base::Value> parsed_message = base::JSONReader::Read(message);
-  if (!parsed_message || !parsed_message->is_dict())
+  ProtocolMessage parsed;
+  if (!ProtocolMessageScanner(message).Scan(&parsed))
     return;
-  base::DictionaryValue* dict =
-      static_cast<base::DictionaryValue*>(parsed_message.get());
-  int id;
-  if (!dict->GetInteger("id", &id)) {
-    std::string method;
-    if (!dict->GetString("method", &method))
+
+  if (!parsed.has_id) {
+    // Unwanted events are dropped before anything is parsed.
+    if (parsed.method.empty() || !ShouldEmitEvent(parsed.method))
       return;
-    base::DictionaryValue* params_value = nullptr;
-    base::DictionaryValue params;
-    if (dict->GetDictionary("params", &params_value))
-      params.Swap(params_value);
-    Emit("message", method, params);
+
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    Emit("message", parsed.method.as_string(),
+         ProtocolValueToV8(parsed.params));
   } else {
-    auto it = pending_requests_.find(id);
+    auto it = pending_requests_.find(parsed.id);
     if (it == pending_requests_.end())
       return;
 
     scoped_refptr<atom::util::Promise> promise = it->second;
     pending_requests_.erase(it);
 
-    base::DictionaryValue* error = nullptr;
-    if (dict->GetDictionary("error", &error)) {
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    if (!parsed.error.empty()) {
       std::string message;
-      error->GetString("message", &message);
+      std::unique_ptr<base::Value> error =
+          base::JSONReader::Read(parsed.error);
+      if (error && error->is_dict())
+        static_cast<base::DictionaryValue*>(error.get())
+            ->GetString("message", &message);
       promise->RejectWithErrorMessage(message);
     } else {
-      base::DictionaryValue* result_body = nullptr;
-      base::DictionaryValue result;
-      if (dict->GetDictionary("result", &result_body)) {
-        result.Swap(result_body);
-      }
-      promise->Resolve(result);
+      promise->Resolve(ProtocolValueToV8(parsed.result));
     }
   }
 }
@@ -142,25 +295,100 @@ v8::Local<v8::Promise> Debugger::SendCommand(mate::Arguments* args) {
     return promise->GetHandle();
   }
 
-  base::DictionaryValue command_params;
-  args->GetNext(&command_params);
-
-  base::DictionaryValue request;
   int request_id = ++previous_request_id_;
-  pending_requests_[request_id] = promise;
-  request.SetInteger("id", request_id);
-  request.SetString("method", method);
-  if (!command_params.empty())
-    request.Set("params",
-                base::Value::ToUniquePtrValue(command_params.Clone()));
-
   std::string json_args;
-  base::JSONWriter::Write(request, &json_args);
+  v8::Local<v8::Value> next = args->PeekNext();
+  if (!next.IsEmpty() && next->IsString()) {
+    // The params are already serialized, write the request around them. They
+    // have to be exactly one object, or they could add members to the request.
+    std::string command_params;
+    args->GetNext(&command_params);
+    if (!command_params.empty() &&
+        !ProtocolMessageScanner(command_params).ScanObject()) {
+      promise->Reject(v8::Exception::TypeError(mate::StringToV8(
+          isolate(), "commandParams must be a JSON serialized object")));
+      return promise->GetHandle();
+    }
+    json_args = base::StringPrintf("{\"id\":%d,\"method\":", request_id);
+    base::EscapeJSONString(method, true, &json_args);
+    if (!command_params.empty())
+      json_args += ",\"params\":" + command_params;
+    json_args += "}";
+  } else {
+    base::DictionaryValue command_params;
+    args->GetNext(&command_params);
+
+    base::DictionaryValue request;
+    request.SetInteger("id", request_id);
+    request.SetString("method", method);
+    if (!command_params.empty())
+      request.Set("params",
+                  base::Value::ToUniquePtrValue(command_params.Clone()));
+    base::JSONWriter::Write(request, &json_args);
+  }
+
+  pending_requests_[request_id] = promise;
   agent_host_->DispatchProtocolMessage(this, json_args);
 
   return promise->GetHandle();
 }
 
+void Debugger::SetEventFilter(mate::Arguments* args) {
+  std::vector<std::string> methods;
+  args->GetNext(&methods);
+
+  event_methods_.clear();
+  event_domains_.clear();
+  for (const auto& method : methods) {
+    if (base::EndsWith(method, ".*", base::CompareCase::SENSITIVE))
+      event_domains_.insert(method.substr(0, method.size() - 1));
+    else
+      event_methods_.insert(method);
+  }
+  filter_events_ = !methods.empty();
+}
+
+void Debugger::SetMessageFormat(const std::string& format,
+                                mate::Arguments* args) {
+  if (format == "object") {
+    message_format_ = MessageFormat::kObject;
+  } else if (format == "json") {
+    message_format_ = MessageFormat::kJSON;
+  } else {
+    args->ThrowError("Invalid message format: " + format);
+  }
+}
+
+bool Debugger::ShouldEmitEvent(base::StringPiece method) const {
+  if (!filter_events_ || event_methods_.count(method))
+    return true;
+  size_t dot = method.find('.');
+  return dot != base::StringPiece::npos &&
+         event_domains_.count(method.substr(0, dot + 1));
+}
+
+v8::Local<v8::Value> Debugger::ProtocolValueToV8(base::StringPiece json) {
+  v8::Local<v8::Context> context = GetWrapper()->CreationContext();
+  v8::Context::Scope context_scope(context);
+
+  if (json.empty())
+    json = "{}";
+  v8::Local<v8::String> str;
+  if (!v8::String::NewFromUtf8(isolate(), json.data(),
+                               v8::NewStringType::kNormal, json.size())
+           .ToLocal(&str))
+    return v8::Object::New(isolate());
+  if (message_format_ == MessageFormat::kJSON)
+    return str;
+
+  // Parsing straight into V8 saves building a base::Value tree first.
+  v8::TryCatch try_catch(isolate());
+  v8::Local<v8::Value> value;
+  if (!v8::JSON::Parse(context, str).ToLocal(&value))
+    return v8::Object::New(isolate());
+  return value;
+}
+
 void Debugger::ClearPendingRequests() {
   for (const auto& it : pending_requests_)
     it.second->RejectWithErrorMessage("target closed while handling command");
@@ -180,7 +408,9 @@ void Debugger::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("attach", &Debugger::Attach)
       .SetMethod("isAttached", &Debugger::IsAttached)
       .SetMethod("detach", &Debugger::Detach)
-      .SetMethod("sendCommand", &Debugger::SendCommand);
+      .SetMethod("sendCommand", &Debugger::SendCommand)
+      .SetMethod("setEventFilter", &Debugger::SetEventFilter)
+      .SetMethod("setMessageFormat", &Debugger::SetMessageFormat);
 }
 
 }  // namespace api
@@ -11,6 +11,8 @@
 #include "atom/browser/api/trackable_object.h"
 #include "atom/common/promise_util.h"
 #include "base/callback.h"
+#include "base/containers/flat_set.h"
+#include "base/strings/string_piece.h"
 #include "base/values.h"
 #include "content/public/browser/devtools_agent_host_client.h"
 #include "content/public/browser/web_contents_observer.h"
@@ -56,18 +58,37 @@ class Debugger : public mate::TrackableObject<Debugger>,
  private:
   using PendingRequestMap = std::map<int, scoped_refptr<atom::util::Promise>>;
 
+  // How event params and command results are handed to JavaScript.
+  enum class MessageFormat {
+    kObject,  // Parsed into objects.
+    kJSON,    // Left as JSON strings.
+  };
+
   void Attach(mate::Arguments* args);
   bool IsAttached();
   void Detach();
   v8::Local<v8::Promise> SendCommand(mate::Arguments* args);
+  void SetEventFilter(mate::Arguments* args);
+  void SetMessageFormat(const std::string& format, mate::Arguments* args);
   void ClearPendingRequests();
 
+  bool ShouldEmitEvent(base::StringPiece method) const;
+  v8::Local<v8::Value> ProtocolValueToV8(base::StringPiece json);
+
   content::WebContents* web_contents_;  // Weak Reference.
   scoped_refptr<content::DevToolsAgentHost> agent_host_;
 
   PendingRequestMap pending_requests_;
   int previous_request_id_ = 0;
 
+  MessageFormat message_format_ = MessageFormat::kObject;
+
+  // The events that reach JavaScript, all of them when |filter_events_| is
+  // false. |event_domains_| holds the "Domain." prefixes of "Domain.*".
+  bool filter_events_ = false;
+  base::flat_set<std::string> event_methods_;
+  base::flat_set<std::string> event_domains_;
+
   DISALLOW_COPY_AND_ASSIGN(Debugger);
 };
 
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_download_item.h"
 
+#include <algorithm>
 #include <map>
 
 #include "atom/browser/atom_browser_main_parts.h"
@@ -11,6 +12,7 @@
 #include "atom/common/native_mate_converters/file_dialog_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
+#include "base/bind.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "native_mate/dictionary.h"
@@ -79,15 +81,33 @@ DownloadItem::~DownloadItem() {
 
 void DownloadItem::OnDownloadUpdated(download::DownloadItem* item) {
   if (download_item_->IsDone()) {
+    // The pending update would be older than the final state.
+    update_timer_.Stop();
     Emit("done", item->GetState());
     // Destroy the item once item is downloaded.
     base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
                                                   GetDestroyClosure());
+    return;
+  }
+
+  if (update_timer_.IsRunning())
+    return;
+  base::TimeDelta since_last_update =
+      base::TimeTicks::Now() - last_update_time_;
+  if (since_last_update >= update_interval_) {
+    EmitUpdated();
   } else {
-    Emit("updated", item->GetState());
+    update_timer_.Start(
+        FROM_HERE, update_interval_ - since_last_update,
+        base::BindOnce(&DownloadItem::EmitUpdated, base::Unretained(this)));
   }
 }
 
+void DownloadItem::EmitUpdated() {
+  last_update_time_ = base::TimeTicks::Now();
+  Emit("updated", download_item_->GetState());
+}
+
 void DownloadItem::OnDownloadDestroyed(download::DownloadItem* download_item) {
   download_item_ = nullptr;
   // Destroy the native class immediately when downloadItem is destroyed.
@@ -187,6 +207,14 @@ double DownloadItem::GetStartTime() const {
   return download_item_->GetStartTime().ToDoubleT();
 }
 
+void DownloadItem::SetUpdateInterval(int interval) {
+  update_interval_ = base::TimeDelta::FromMilliseconds(std::max(interval, 0));
+}
+
+int DownloadItem::GetUpdateInterval() const {
+  return update_interval_.InMilliseconds();
+}
+
 // static
 void DownloadItem::BuildPrototype(v8::Isolate* isolate,
                                   v8::Local<v8::FunctionTemplate> prototype) {
@@ -214,7 +242,28 @@ void DownloadItem::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("getSaveDialogOptions", &DownloadItem::GetSaveDialogOptions)
       .SetMethod("getLastModifiedTime", &DownloadItem::GetLastModifiedTime)
       .SetMethod("getETag", &DownloadItem::GetETag)
-      .SetMethod("getStartTime", &DownloadItem::GetStartTime);
+      .SetMethod("getStartTime", &DownloadItem::GetStartTime)
+      .SetMethod("setUpdateInterval", &DownloadItem::SetUpdateInterval)
+      .SetMethod("getUpdateInterval", &DownloadItem::GetUpdateInterval);
+}
+
+// static
+v8::Local<v8::Value> DownloadItem::GetProgressSnapshot(
+    v8::Isolate* isolate,
+    download::DownloadItem* item) {
+  auto* existing = TrackableObject::FromWrappedClass(isolate, item);
+  if (!existing)
+    return v8::Local<v8::Value>();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("item", existing->GetWrapper());
+  dict.Set("url", item->GetURL());
+  dict.Set("state", item->GetState());
+  dict.Set("paused", item->IsPaused());
+  dict.Set("receivedBytes", item->GetReceivedBytes());
+  dict.Set("totalBytes", item->GetTotalBytes());
+  dict.Set("currentBytesPerSecond", item->CurrentSpeed());
+  return dict.GetHandle();
 }
 
 // static
@@ -11,6 +11,8 @@
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/ui/file_dialog.h"
 #include "base/files/file_path.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "components/download/public/common/download_item.h"
 #include "native_mate/handle.h"
 #include "url/gurl.h"
@@ -28,6 +30,11 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
+  // Returns the progress of the wrapped download in one object, or an empty
+  // handle when |item| is not exposed to JavaScript.
+  static v8::Local<v8::Value> GetProgressSnapshot(v8::Isolate* isolate,
+                                                  download::DownloadItem* item);
+
   void Pause();
   bool IsPaused() const;
   void Resume();
@@ -50,6 +57,13 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   std::string GetLastModifiedTime() const;
   std::string GetETag() const;
   double GetStartTime() const;
+  // The minimum interval between "updated" events, in milliseconds.
+  void SetUpdateInterval(int interval);
+  int GetUpdateInterval() const;
+
+  void set_update_interval(base::TimeDelta interval) {
+    update_interval_ = interval;
+  }
 
  protected:
   DownloadItem(v8::Isolate* isolate, download::DownloadItem* download_item);
@@ -60,10 +74,18 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   void OnDownloadDestroyed(download::DownloadItem* download) override;
 
  private:
+  void EmitUpdated();
+
   base::FilePath save_path_;
   file_dialog::DialogSettings dialog_options_;
   download::DownloadItem* download_item_;
 
+  // The "updated" events are coalesced to at most one per |update_interval_|,
+  // the latest state being delivered when |update_timer_| fires.
+  base::TimeDelta update_interval_;
+  base::TimeTicks last_update_time_;
+  base::OneShotTimer update_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(DownloadItem);
 };
 
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_session.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -22,14 +23,17 @@
 #include "atom/browser/media/media_device_id_salt.h"
 #include "atom/browser/net/atom_cert_verifier.h"
 #include "atom/browser/session_preferences.h"
+#include "atom/browser/spare_renderer_pool.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/options_switches.h"
 #include "base/files/file_path.h"
 #include "base/guid.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
@@ -58,6 +62,7 @@
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "ui/base/l10n/l10n_util.h"
+#include "url/url_constants.h"
 
 #include "atom/common/node_includes.h"
 
@@ -66,6 +71,10 @@ using content::StoragePartition;
 
 namespace {
 
+// Seconds a cacheable result of the certificate verify proc is reused for
+// when no maxAge is given.
+const int kDefaultCertVerifyCacheMaxAge = 60;
+
 struct ClearStorageDataOptions {
   GURL origin;
   uint32_t storage_types = StoragePartition::REMOVE_DATA_MASK_ALL;
@@ -184,6 +193,26 @@ struct Converter<ClearAuthCacheOptions> {
   }
 };
 
+template <>
+struct Converter<atom::AtomPermissionManager::Decision> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     atom::AtomPermissionManager::Decision* out) {
+    if (val->IsBoolean())
+      return ConvertFromV8(isolate, val, &out->granted);
+
+    mate::Dictionary options;
+    if (!ConvertFromV8(isolate, val, &options) ||
+        !options.Get("granted", &out->granted))
+      return false;
+    options.Get("cache", &out->cache);
+    double ttl = 0;
+    if (options.Get("ttl", &ttl) && ttl > 0)
+      out->ttl = base::TimeDelta::FromMillisecondsD(ttl);
+    return true;
+  }
+};
+
 template <>
 struct Converter<atom::VerifyRequestParams> {
   static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
@@ -275,6 +304,16 @@ void SetCertVerifyProcInIO(
       ->SetVerifyProc(proc);
 }
 
+void ClearCertVerifyCacheInIO(
+    const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+    const base::Closure& callback) {
+  auto* request_context = context_getter->GetURLRequestContext();
+  static_cast<AtomCertVerifier*>(request_context->cert_verifier())
+      ->ClearVerifyCache();
+  if (!callback.is_null())
+    RunCallbackInUI(callback);
+}
+
 void ClearHostResolverCacheInIO(
     const scoped_refptr<net::URLRequestContextGetter>& context_getter,
     const base::Closure& callback) {
@@ -403,6 +442,7 @@ void Session::OnDownloadCreated(content::DownloadManager* manager,
   v8::Locker locker(isolate());
   v8::HandleScope handle_scope(isolate());
   auto handle = DownloadItem::Create(isolate(), item);
+  handle->set_update_interval(download_update_interval_);
   if (item->GetState() == download::DownloadItem::INTERRUPTED)
     handle->SetSavePath(item->GetTargetFilePath());
   content::WebContents* web_contents =
@@ -420,6 +460,11 @@ void Session::ResolveProxy(
   browser_context_->GetResolveProxyHelper()->ResolveProxy(url, callback);
 }
 
+void Session::SetMaxConcurrentProxyLookups(int max_concurrent_lookups) {
+  browser_context_->GetResolveProxyHelper()->SetMaxConcurrentLookups(
+      std::max(max_concurrent_lookups, 1));
+}
+
 template <Session::CacheAction action>
 void Session::DoCacheAction(const net::CompletionCallback& callback) {
   base::PostTaskWithTraits(
@@ -482,6 +527,8 @@ void Session::SetProxy(const mate::Dictionary& options,
         WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
   }
 
+  browser_context_->GetResolveProxyHelper()->ClearCache();
+
   base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE, callback);
 }
 
@@ -516,17 +563,40 @@ void Session::DisableNetworkEmulation() {
       network_emulation_token_, network::mojom::NetworkConditions::New());
 }
 
-void WrapVerifyProc(base::Callback<void(const VerifyRequestParams& request,
-                                        base::Callback<void(int)>)> proc,
-                    const VerifyRequestParams& request,
-                    base::OnceCallback<void(int)> cb) {
-  proc.Run(request, base::AdaptCallbackForRepeating(std::move(cb)));
+// Handles callback(verificationResult[, { cacheable, maxAge }]) of the verify
+// proc.
+void OnVerifyProcDone(const base::Callback<void(int, int)>& done,
+                      mate::Arguments* args) {
+  int result;
+  if (!args->GetNext(&result)) {
+    args->ThrowError("Must pass a verification result");
+    return;
+  }
+
+  mate::Dictionary options;
+  bool cacheable = false;
+  int max_age = kDefaultCertVerifyCacheMaxAge;
+  if (args->GetNext(&options)) {
+    options.Get("cacheable", &cacheable);
+    options.Get("maxAge", &max_age);
+  }
+  done.Run(result, cacheable ? std::max(max_age, 0) : 0);
+}
+
+void WrapVerifyProc(
+    base::Callback<void(const VerifyRequestParams& request,
+                        base::Callback<void(mate::Arguments*)>)> proc,
+    const VerifyRequestParams& request,
+    AtomCertVerifier::VerifyResultCallback cb) {
+  proc.Run(request,
+           base::Bind(&OnVerifyProcDone,
+                      base::AdaptCallbackForRepeating(std::move(cb))));
 }
 
 void Session::SetCertVerifyProc(v8::Local<v8::Value> val,
                                 mate::Arguments* args) {
   base::Callback<void(const VerifyRequestParams& request,
-                      base::Callback<void(int)>)>
+                      base::Callback<void(mate::Arguments*)>)>
       proc;
   if (!(val->IsNull() || mate::ConvertFromV8(args->isolate(), val, &proc))) {
     args->ThrowError("Must pass null or function");
@@ -564,6 +634,44 @@ void Session::SetPermissionCheckHandler(v8::Local<v8::Value> val,
   permission_manager->SetPermissionCheckHandler(handler);
 }
 
+void Session::ClearCertificateVerifyCache(mate::Arguments* args) {
+  base::Closure callback;
+  args->GetNext(&callback);
+
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&ClearCertVerifyCacheInIO,
+                     WrapRefCounted(browser_context_->GetRequestContext()),
+                     callback));
+}
+
+void Session::ClearPermissionDecisions() {
+  auto* permission_manager = static_cast<AtomPermissionManager*>(
+      browser_context()->GetPermissionControllerDelegate());
+  permission_manager->ClearPermissionDecisions();
+}
+
+void Session::SetDownloadUpdateInterval(int interval) {
+  download_update_interval_ =
+      base::TimeDelta::FromMilliseconds(std::max(interval, 0));
+}
+
+v8::Local<v8::Value> Session::GetDownloadsSnapshot(v8::Isolate* isolate) {
+  std::vector<download::DownloadItem*> items;
+  content::BrowserContext::GetDownloadManager(browser_context())
+      ->GetAllDownloads(&items);
+
+  std::vector<v8::Local<v8::Value>> snapshot;
+  for (auto* item : items) {
+    if (item->IsDone())
+      continue;
+    auto progress = DownloadItem::GetProgressSnapshot(isolate, item);
+    if (!progress.IsEmpty())
+      snapshot.push_back(progress);
+  }
+  return mate::ConvertToV8(isolate, snapshot);
+}
+
 void Session::ClearHostResolverCache(mate::Arguments* args) {
   base::Closure callback;
   args->GetNext(&callback);
@@ -673,6 +781,50 @@ std::vector<base::FilePath::StringType> Session::GetPreloads() const {
   return prefs->preloads();
 }
 
+void Session::SetCodeCacheSchemes(const std::vector<std::string>& schemes,
+                                  mate::Arguments* args) {
+  // Only local schemes the app serves itself are trusted to fill the cache.
+  std::vector<std::string> standard_schemes = GetStandardSchemes();
+  for (const auto& scheme : schemes) {
+    if (scheme != url::kFileScheme &&
+        !base::ContainsValue(standard_schemes, scheme)) {
+      args->ThrowError("Scheme " + scheme +
+                       " is neither file nor a privileged standard scheme");
+      return;
+    }
+  }
+
+  auto* prefs = SessionPreferences::FromBrowserContext(browser_context());
+  DCHECK(prefs);
+  prefs->set_code_cache_schemes(schemes);
+}
+
+std::vector<std::string> Session::GetCodeCacheSchemes() const {
+  auto* prefs = SessionPreferences::FromBrowserContext(browser_context());
+  DCHECK(prefs);
+  return prefs->code_cache_schemes();
+}
+
+void Session::SetSpareRendererPool(const mate::Dictionary& options) {
+  int size = 0;
+  options.Get("size", &size);
+  mate::Dictionary web_preferences =
+      mate::Dictionary::CreateEmpty(options.isolate());
+  options.Get(options::kWebPreferences, &web_preferences);
+
+  auto* pool = SpareRendererPool::FromBrowserContext(browser_context());
+  if (!pool)
+    pool = new SpareRendererPool(browser_context());
+  pool->SetOptions(std::max(size, 0), web_preferences);
+}
+
+std::vector<base::ProcessId> Session::GetSpareRendererPids() const {
+  auto* pool = SpareRendererPool::FromBrowserContext(browser_context());
+  if (!pool)
+    return std::vector<base::ProcessId>();
+  return pool->GetProcessIds();
+}
+
 v8::Local<v8::Value> Session::Cookies(v8::Isolate* isolate) {
   if (cookies_.IsEmpty()) {
     auto handle = Cookies::Create(isolate, browser_context());
@@ -748,6 +900,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .MakeDestroyable()
       .SetMethod("resolveProxy", &Session::ResolveProxy)
+      .SetMethod("setMaxConcurrentProxyLookups",
+                 &Session::SetMaxConcurrentProxyLookups)
       .SetMethod("getCacheSize", &Session::DoCacheAction<CacheAction::STATS>)
       .SetMethod("clearCache", &Session::DoCacheAction<CacheAction::CLEAR>)
       .SetMethod("clearStorageData", &Session::ClearStorageData)
@@ -757,10 +911,17 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("enableNetworkEmulation", &Session::EnableNetworkEmulation)
       .SetMethod("disableNetworkEmulation", &Session::DisableNetworkEmulation)
       .SetMethod("setCertificateVerifyProc", &Session::SetCertVerifyProc)
+      .SetMethod("clearCertificateVerifyCache",
+                 &Session::ClearCertificateVerifyCache)
       .SetMethod("setPermissionRequestHandler",
                  &Session::SetPermissionRequestHandler)
       .SetMethod("setPermissionCheckHandler",
                  &Session::SetPermissionCheckHandler)
+      .SetMethod("clearPermissionDecisions",
+                 &Session::ClearPermissionDecisions)
+      .SetMethod("setDownloadUpdateInterval",
+                 &Session::SetDownloadUpdateInterval)
+      .SetMethod("getDownloadsSnapshot", &Session::GetDownloadsSnapshot)
       .SetMethod("clearHostResolverCache", &Session::ClearHostResolverCache)
       .SetMethod("clearAuthCache", &Session::ClearAuthCache)
       .SetMethod("allowNTLMCredentialsForDomains",
@@ -772,6 +933,10 @@ void Session::BuildPrototype(v8::Isolate* isolate,
                  &Session::CreateInterruptedDownload)
       .SetMethod("setPreloads", &Session::SetPreloads)
       .SetMethod("getPreloads", &Session::GetPreloads)
+      .SetMethod("setCodeCacheSchemes", &Session::SetCodeCacheSchemes)
+      .SetMethod("getCodeCacheSchemes", &Session::GetCodeCacheSchemes)
+      .SetMethod("setSpareRendererPool", &Session::SetSpareRendererPool)
+      .SetMethod("getSpareRendererPids", &Session::GetSpareRendererPids)
       .SetProperty("cookies", &Session::Cookies)
       .SetProperty("netLog", &Session::NetLog)
       .SetProperty("protocol", &Session::Protocol)
@@ -11,6 +11,8 @@
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/atom_blob_reader.h"
 #include "atom/browser/net/resolve_proxy_helper.h"
+#include "base/process/process_handle.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/download_manager.h"
 #include "native_mate/handle.h"
@@ -64,6 +66,7 @@ class Session : public mate::TrackableObject<Session>,
   // Methods.
   void ResolveProxy(const GURL& url,
                     const ResolveProxyHelper::ResolveProxyCallback& callback);
+  void SetMaxConcurrentProxyLookups(int max_concurrent_lookups);
   template <CacheAction action>
   void DoCacheAction(const net::CompletionCallback& callback);
   void ClearStorageData(mate::Arguments* args);
@@ -73,10 +76,14 @@ class Session : public mate::TrackableObject<Session>,
   void EnableNetworkEmulation(const mate::Dictionary& options);
   void DisableNetworkEmulation();
   void SetCertVerifyProc(v8::Local<v8::Value> proc, mate::Arguments* args);
+  void ClearCertificateVerifyCache(mate::Arguments* args);
   void SetPermissionRequestHandler(v8::Local<v8::Value> val,
                                    mate::Arguments* args);
   void SetPermissionCheckHandler(v8::Local<v8::Value> val,
                                  mate::Arguments* args);
+  void ClearPermissionDecisions();
+  void SetDownloadUpdateInterval(int interval);
+  v8::Local<v8::Value> GetDownloadsSnapshot(v8::Isolate* isolate);
   void ClearHostResolverCache(mate::Arguments* args);
   void ClearAuthCache(mate::Arguments* args);
   void AllowNTLMCredentialsForDomains(const std::string& domains);
@@ -87,6 +94,11 @@ class Session : public mate::TrackableObject<Session>,
   void CreateInterruptedDownload(const mate::Dictionary& options);
   void SetPreloads(const std::vector<base::FilePath::StringType>& preloads);
   std::vector<base::FilePath::StringType> GetPreloads() const;
+  void SetCodeCacheSchemes(const std::vector<std::string>& schemes,
+                           mate::Arguments* args);
+  std::vector<std::string> GetCodeCacheSchemes() const;
+  void SetSpareRendererPool(const mate::Dictionary& options);
+  std::vector<base::ProcessId> GetSpareRendererPids() const;
   v8::Local<v8::Value> Cookies(v8::Isolate* isolate);
   v8::Local<v8::Value> Protocol(v8::Isolate* isolate);
   v8::Local<v8::Value> WebRequest(v8::Isolate* isolate);
@@ -110,6 +122,9 @@ class Session : public mate::TrackableObject<Session>,
   // The client id to enable the network throttler.
   base::UnguessableToken network_emulation_token_;
 
+  // The minimum interval between the "updated" events of new downloads.
+  base::TimeDelta download_update_interval_;
+
   scoped_refptr<AtomBrowserContext> browser_context_;
 
   DISALLOW_COPY_AND_ASSIGN(Session);
@@ -4,10 +4,13 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_browser_window.h"
 #include "atom/browser/api/atom_api_debugger.h"
@@ -19,6 +22,7 @@
 #include "atom/browser/atom_navigation_throttle.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/child_web_contents_tracker.h"
+#include "atom/browser/direct_channel_message_filter.h"
 #include "atom/browser/lib/bluetooth_chooser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
@@ -49,8 +53,10 @@
 #include "base/message_loop/message_loop.h"
 #include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/ssl/security_state_tab_helper.h"
@@ -59,6 +65,7 @@
 #include "content/browser/renderer_host/render_widget_host_impl.h"
 #include "content/browser/renderer_host/render_widget_host_view_base.h"
 #include "content/common/widget_messages.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "content/public/browser/download_request_utils.h"
 #include "content/public/browser/favicon_status.h"
@@ -249,6 +256,103 @@ void OnCapturePageDone(scoped_refptr<util::Promise> promise,
   promise->Resolve(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+// Messages the renderer sends on its own have no trace id, only the ones sent
+// by ipcRenderer end a flow.
+unsigned int GetTraceFlowFlags(uint64_t trace_id) {
+  return trace_id ? TRACE_EVENT_FLAG_FLOW_IN : TRACE_EVENT_FLAG_NONE;
+}
+
+// Returns the live frame with |frame_id| in |api_web_contents|, a |frame_id|
+// of 0 means the main frame.
+content::RenderFrameHost* FindLiveFrame(WebContents* api_web_contents,
+                                        int32_t frame_id) {
+  auto* web_contents = api_web_contents->web_contents();
+  if (!web_contents)
+    return nullptr;
+
+  content::RenderFrameHost* frame_host = nullptr;
+  if (frame_id == 0) {
+    frame_host = web_contents->GetMainFrame();
+  } else {
+    for (auto* frame : web_contents->GetAllFrames()) {
+      if (frame->GetRoutingID() == frame_id) {
+        frame_host = frame;
+        break;
+      }
+    }
+  }
+  if (!frame_host || !frame_host->IsRenderFrameLive())
+    return nullptr;
+  return frame_host;
+}
+
+#if BUILDFLAG(ENABLE_OSR)
+// Owns a frame passed to JS as a buffer over its pixels, and gives it back to
+// the frame pool once JS releases the frame or the buffer is garbage collected.
+class PaintFrameHolder : public base::RefCounted<PaintFrameHolder> {
+ public:
+  PaintFrameHolder(const SkBitmap& bitmap,
+                   scoped_refptr<OffScreenFramePool> pool)
+      : bitmap_(bitmap), pool_(std::move(pool)) {}
+
+  v8::Local<v8::Object> CreateBuffer(v8::Isolate* isolate) {
+    // Balanced in OnBufferFreed.
+    AddRef();
+    auto buffer =
+        node::Buffer::New(isolate, static_cast<char*>(bitmap_.getPixels()),
+                          bitmap_.computeByteSize(), &OnBufferFreed, this)
+            .ToLocalChecked();
+    buffer_.Reset(isolate, buffer);
+    buffer_.SetWeak();
+    return buffer;
+  }
+
+  // Detaches the buffer from the pixels so the frame can be reused.
+  void ReleaseFrame(v8::Isolate* isolate) {
+    if (released_)
+      return;
+    // The weak handle is only used to reach the buffer. When it is gone, or
+    // the buffer can not be detached, JS may still read the pixels and the
+    // bitmap stays with the holder until OnBufferFreed.
+    if (buffer_.IsEmpty())
+      return;
+    v8::HandleScope handle_scope(isolate);
+    auto array_buffer = buffer_.Get(isolate).As<v8::Uint8Array>()->Buffer();
+    if (!array_buffer->IsNeuterable())
+      return;
+    array_buffer->Neuter();
+    buffer_.Reset();
+    Recycle();
+  }
+
+ private:
+  friend class base::RefCounted<PaintFrameHolder>;
+  ~PaintFrameHolder() = default;
+
+  static void OnBufferFreed(char* data, void* hint) {
+    auto* self = static_cast<PaintFrameHolder*>(hint);
+    self->Recycle();
+    self->Release();
+  }
+
+  void Recycle() {
+    if (released_)
+      return;
+    released_ = true;
+    if (pool_)
+      pool_->Recycle(std::move(bitmap_));
+    bitmap_.reset();
+  }
+
+  SkBitmap bitmap_;
+  scoped_refptr<OffScreenFramePool> pool_;
+  v8::Global<v8::Object> buffer_;
+  bool released_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintFrameHolder);
+};
+#endif
+
 }  // namespace
 
 struct WebContents::FrameDispatchHelper {
@@ -268,9 +372,10 @@ struct WebContents::FrameDispatchHelper {
   void OnRendererMessageSync(bool internal,
                              const std::string& channel,
                              const base::ListValue& args,
+                             uint64_t trace_id,
                              IPC::Message* message) {
     api_web_contents->OnRendererMessageSync(rfh, internal, channel, args,
-                                            message);
+                                            trace_id, message);
   }
 };
 
@@ -894,6 +999,11 @@ void WebContents::DidStartNavigation(
   EmitNavigationEvent("did-start-navigation", navigation_handle);
 }
 
+void WebContents::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  CloseFrameDirectChannels(render_frame_host);
+}
+
 void WebContents::DidRedirectNavigation(
     content::NavigationHandle* navigation_handle) {
   EmitNavigationEvent("did-redirect-navigation", navigation_handle);
@@ -910,6 +1020,9 @@ void WebContents::DidFinishNavigation(
   if (frame_host) {
     frame_process_id = frame_host->GetProcess()->GetID();
     frame_routing_id = frame_host->GetRoutingID();
+    // The direct channels were opened for the previous document.
+    if (!navigation_handle->IsSameDocument())
+      CloseFrameDirectChannels(frame_host);
   }
   if (!navigation_handle->IsErrorPage()) {
     auto url = navigation_handle->GetURL();
@@ -1649,6 +1762,8 @@ bool WebContents::SendIPCMessageWithSender(bool internal,
                                            const std::string& channel,
                                            const base::ListValue& args,
                                            int32_t sender_id) {
+  TRACE_EVENT1("electron.ipc", "WebContents::SendIPCMessage", "channel",
+               channel);
   auto* frame_host = web_contents()->GetMainFrame();
   if (frame_host) {
     return frame_host->Send(new AtomFrameMsg_Message(frame_host->GetRoutingID(),
@@ -1658,11 +1773,99 @@ bool WebContents::SendIPCMessageWithSender(bool internal,
   return false;
 }
 
+// static
+int WebContents::Broadcast(v8::Isolate* isolate,
+                           bool internal,
+                           bool send_to_all,
+                           const std::vector<int32_t>& web_contents_ids,
+                           const std::vector<int32_t>& frame_ids,
+                           const std::string& channel,
+                           const base::ListValue& args) {
+  TRACE_EVENT2("electron.ipc", "WebContents::Broadcast", "channel", channel,
+               "targets", web_contents_ids.size());
+  if (web_contents_ids.size() != frame_ids.size())
+    return 0;
+
+  // Pickle the arguments once, each target only gets a copy of the serialized
+  // payload with its own routing ID.
+  AtomFrameMsg_Message message(MSG_ROUTING_NONE, internal, send_to_all,
+                               channel, args, 0 /* sender_id */);
+  int sent = 0;
+  for (size_t i = 0; i < web_contents_ids.size(); ++i) {
+    auto* web_contents =
+        TrackableObject::FromWeakMapID(isolate, web_contents_ids[i]);
+    if (!web_contents)
+      continue;
+
+    auto* frame_host = FindLiveFrame(web_contents, frame_ids[i]);
+    if (!frame_host)
+      continue;
+
+    auto* copy = new IPC::Message(message);
+    copy->set_routing_id(frame_host->GetRoutingID());
+    if (frame_host->Send(copy))
+      ++sent;
+  }
+  return sent;
+}
+
+// static
+int32_t WebContents::CreateDirectChannel(v8::Isolate* isolate,
+                                         int32_t first_web_contents_id,
+                                         int32_t first_frame_id,
+                                         int32_t second_web_contents_id,
+                                         int32_t second_frame_id) {
+  auto* first = TrackableObject::FromWeakMapID(isolate, first_web_contents_id);
+  auto* second =
+      TrackableObject::FromWeakMapID(isolate, second_web_contents_id);
+  if (!first || !second)
+    return -1;
+
+  auto* first_frame = FindLiveFrame(first, first_frame_id);
+  auto* second_frame = FindLiveFrame(second, second_frame_id);
+  if (!first_frame || !second_frame)
+    return -1;
+
+  static int32_t next_channel_id = 0;
+  int32_t channel_id = ++next_channel_id;
+  DirectChannelMessageFilter::Endpoint first_endpoint = {
+      first_frame->GetProcess()->GetID(), first_frame->GetRoutingID(),
+      first_web_contents_id};
+  DirectChannelMessageFilter::Endpoint second_endpoint = {
+      second_frame->GetProcess()->GetID(), second_frame->GetRoutingID(),
+      second_web_contents_id};
+  // Any IPC sent from now on to the renderers is queued on the IO thread
+  // behind this task, so the channel is ready before its ID can be used.
+  base::PostTaskWithTraits(
+      FROM_HERE, {content::BrowserThread::IO},
+      base::BindOnce(&DirectChannelMessageFilter::OpenChannel, channel_id,
+                     first_endpoint, second_endpoint));
+  return channel_id;
+}
+
+// static
+void WebContents::CloseDirectChannel(int32_t channel_id) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {content::BrowserThread::IO},
+      base::BindOnce(&DirectChannelMessageFilter::CloseChannel, channel_id));
+}
+
+void WebContents::CloseFrameDirectChannels(
+    content::RenderFrameHost* frame_host) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {content::BrowserThread::IO},
+      base::BindOnce(&DirectChannelMessageFilter::CloseFrameChannels,
+                     frame_host->GetProcess()->GetID(),
+                     frame_host->GetRoutingID()));
+}
+
 bool WebContents::SendIPCMessageToFrame(bool internal,
                                         bool send_to_all,
                                         int32_t frame_id,
                                         const std::string& channel,
                                         const base::ListValue& args) {
+  TRACE_EVENT1("electron.ipc", "WebContents::SendIPCMessageToFrame", "channel",
+               channel);
   auto frames = web_contents()->GetAllFrames();
   auto iter = std::find_if(frames.begin(), frames.end(), [frame_id](auto* f) {
     return f->GetRoutingID() == frame_id;
@@ -1725,17 +1928,48 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
 }
 
 void WebContents::BeginFrameSubscription(mate::Arguments* args) {
-  bool only_dirty = false;
+  FrameSubscriberOptions options;
   FrameSubscriber::FrameCaptureCallback callback;
 
-  args->GetNext(&only_dirty);
+  v8::Local<v8::Value> next = args->PeekNext();
+  if (!next.IsEmpty() && next->IsObject() && !next->IsFunction()) {
+    mate::Dictionary dict;
+    args->GetNext(&dict);
+    dict.Get("onlyDirty", &options.only_dirty);
+    dict.Get("size", &options.size);
+    dict.Get("region", &options.region);
+    dict.Get("zeroCopy", &options.zero_copy);
+    double max_frame_rate;
+    if (dict.Get("maxFrameRate", &max_frame_rate)) {
+      // A fractional rate would be truncated, possibly to 0.
+      if (max_frame_rate < 1 ||
+          max_frame_rate > std::numeric_limits<int>::max() ||
+          max_frame_rate != std::floor(max_frame_rate)) {
+        args->ThrowError("maxFrameRate must be a positive integer");
+        return;
+      }
+      options.max_frame_rate = static_cast<int>(max_frame_rate);
+    }
+    std::string format;
+    if (dict.Get("format", &format)) {
+      if (format == "i420") {
+        options.format = media::PIXEL_FORMAT_I420;
+      } else if (format != "bgra") {
+        args->ThrowError("format must be either 'bgra' or 'i420'");
+        return;
+      }
+    }
+  } else {
+    args->GetNext(&options.only_dirty);
+  }
+
   if (!args->GetNext(&callback)) {
     args->ThrowError();
     return;
   }
 
   frame_subscriber_.reset(
-      new FrameSubscriber(isolate(), web_contents(), callback, only_dirty));
+      new FrameSubscriber(isolate(), web_contents(), callback, options));
 }
 
 void WebContents::EndFrameSubscription() {
@@ -1846,7 +2080,30 @@ bool WebContents::IsOffScreen() const {
 
 #if BUILDFLAG(ENABLE_OSR)
 void WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
-  Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+  if (!zero_copy_paint_) {
+    Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+    return;
+  }
+
+  scoped_refptr<OffScreenFramePool> pool;
+  auto* osr_rwhv = GetOffScreenRenderWidgetHostView();
+  if (osr_rwhv)
+    pool = osr_rwhv->frame_pool();
+
+  v8::HandleScope handle_scope(isolate());
+  auto holder = base::MakeRefCounted<PaintFrameHolder>(bitmap, pool);
+  Emit("-paint-frame", dirty_rect, holder->CreateBuffer(isolate()),
+       bitmap.width(), bitmap.height(),
+       static_cast<uint32_t>(bitmap.rowBytes()),
+       base::Bind(&PaintFrameHolder::ReleaseFrame, holder, isolate()));
+}
+
+void WebContents::SetZeroCopyPaint(bool enabled) {
+  zero_copy_paint_ = enabled;
+}
+
+bool WebContents::IsZeroCopyPaint() const {
+  return zero_copy_paint_;
 }
 
 void WebContents::StartPainting() {
@@ -2051,7 +2308,8 @@ void WebContents::GrantOriginAccess(const GURL& url) {
 }
 
 bool WebContents::TakeHeapSnapshot(const base::FilePath& file_path,
-                                   const std::string& channel) {
+                                   const std::string& channel,
+                                   bool gzip) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
 
   base::File file(file_path,
@@ -2065,7 +2323,7 @@ bool WebContents::TakeHeapSnapshot(const base::FilePath& file_path,
 
   return frame_host->Send(new AtomFrameMsg_TakeHeapSnapshot(
       frame_host->GetRoutingID(),
-      IPC::TakePlatformFileForTransit(std::move(file)), channel));
+      IPC::TakePlatformFileForTransit(std::move(file)), channel, gzip));
 }
 
 // static
@@ -2138,6 +2396,8 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("setZeroCopyPaint", &WebContents::SetZeroCopyPaint)
+      .SetMethod("isZeroCopyPaint", &WebContents::IsZeroCopyPaint)
 #endif
       .SetMethod("invalidate", &WebContents::Invalidate)
       .SetMethod("setZoomLevel", &WebContents::SetZoomLevel)
@@ -2186,7 +2446,11 @@ AtomBrowserContext* WebContents::GetBrowserContext() const {
 void WebContents::OnRendererMessage(content::RenderFrameHost* frame_host,
                                     bool internal,
                                     const std::string& channel,
-                                    const base::ListValue& args) {
+                                    const base::ListValue& args,
+                                    uint64_t trace_id) {
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "WebContents::OnRendererMessage",
+                         trace_id, GetTraceFlowFlags(trace_id), "channel",
+                         channel);
   // webContents.emit('-ipc-message', new Event(), internal, channel, args);
   EmitWithSender("-ipc-message", frame_host, nullptr, internal, channel, args);
 }
@@ -2195,7 +2459,11 @@ void WebContents::OnRendererMessageSync(content::RenderFrameHost* frame_host,
                                         bool internal,
                                         const std::string& channel,
                                         const base::ListValue& args,
+                                        uint64_t trace_id,
                                         IPC::Message* message) {
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "WebContents::OnRendererMessageSync",
+                         trace_id, GetTraceFlowFlags(trace_id), "channel",
+                         channel);
   // webContents.emit('-ipc-message-sync', new Event(sender, message), internal,
   // channel, args);
   EmitWithSender("-ipc-message-sync", frame_host, message, internal, channel,
@@ -2207,7 +2475,11 @@ void WebContents::OnRendererMessageTo(content::RenderFrameHost* frame_host,
                                       bool send_to_all,
                                       int32_t web_contents_id,
                                       const std::string& channel,
-                                      const base::ListValue& args) {
+                                      const base::ListValue& args,
+                                      uint64_t trace_id) {
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "WebContents::OnRendererMessageTo",
+                         trace_id, GetTraceFlowFlags(trace_id), "channel",
+                         channel);
   auto* web_contents = mate::TrackableObject<WebContents>::FromWeakMapID(
       isolate(), web_contents_id);
 
@@ -2219,7 +2491,11 @@ void WebContents::OnRendererMessageTo(content::RenderFrameHost* frame_host,
 
 void WebContents::OnRendererMessageHost(content::RenderFrameHost* frame_host,
                                         const std::string& channel,
-                                        const base::ListValue& args) {
+                                        const base::ListValue& args,
+                                        uint64_t trace_id) {
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "WebContents::OnRendererMessageHost",
+                         trace_id, GetTraceFlowFlags(trace_id), "channel",
+                         channel);
   // webContents.emit('ipc-message-host', new Event(), channel, args);
   EmitWithSender("ipc-message-host", frame_host, nullptr, channel, args);
 }
@@ -2279,6 +2555,9 @@ void Initialize(v8::Local<v8::Object> exports,
                               ->GetFunction(context)
                               .ToLocalChecked());
   dict.SetMethod("create", &WebContents::Create);
+  dict.SetMethod("_broadcast", &WebContents::Broadcast);
+  dict.SetMethod("_createDirectChannel", &WebContents::CreateDirectChannel);
+  dict.SetMethod("_closeDirectChannel", &WebContents::CloseDirectChannel);
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
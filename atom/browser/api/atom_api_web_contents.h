@@ -111,6 +111,28 @@ class WebContents : public mate::TrackableObject<WebContents>,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
+  // Connect two frames with a channel whose messages are relayed on the IO
+  // thread, see DirectChannelMessageFilter. A |frame_id| of 0 means the main
+  // frame. Returns the ID of the channel, or -1 if a frame can not be found.
+  static int32_t CreateDirectChannel(v8::Isolate* isolate,
+                                     int32_t first_web_contents_id,
+                                     int32_t first_frame_id,
+                                     int32_t second_web_contents_id,
+                                     int32_t second_frame_id);
+  static void CloseDirectChannel(int32_t channel_id);
+
+  // Send the same IPC message to the frames identified by |web_contents_ids|
+  // and |frame_ids|, a |frame_id| of 0 means the main frame. The arguments are
+  // serialized only once and the resulting payload is copied to each target.
+  // Returns the number of frames the message was delivered to.
+  static int Broadcast(v8::Isolate* isolate,
+                       bool internal,
+                       bool send_to_all,
+                       const std::vector<int32_t>& web_contents_ids,
+                       const std::vector<int32_t>& frame_ids,
+                       const std::string& channel,
+                       const base::ListValue& args);
+
   // Destroy the managed content::WebContents instance.
   //
   // Note: The |async| should only be |true| when users are expecting to use the
@@ -249,6 +271,10 @@ class WebContents : public mate::TrackableObject<WebContents>,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  // When enabled, paints are passed to JS as buffers over the frame's pixels
+  // which are recycled once released, instead of a NativeImage copy.
+  void SetZeroCopyPaint(bool enabled);
+  bool IsZeroCopyPaint() const;
 #endif
   void Invalidate();
   gfx::Size GetSizeForNewRenderView(content::WebContents*) const override;
@@ -290,7 +316,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void GrantOriginAccess(const GURL& url);
 
   bool TakeHeapSnapshot(const base::FilePath& file_path,
-                        const std::string& channel);
+                        const std::string& channel,
+                        bool gzip);
 
   // Properties.
   int32_t ID() const;
@@ -409,6 +436,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void RenderViewHostChanged(content::RenderViewHost* old_host,
                              content::RenderViewHost* new_host) override;
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentLoadedInFrame(
       content::RenderFrameHost* render_frame_host) override;
@@ -474,17 +502,22 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Called when we receive a CursorChange message from chromium.
   void OnCursorChange(const content::WebCursor& cursor);
 
+  // Closes the direct channels of |frame_host|, whose document is gone.
+  void CloseFrameDirectChannels(content::RenderFrameHost* frame_host);
+
   // Called when received a message from renderer.
   void OnRendererMessage(content::RenderFrameHost* frame_host,
                          bool internal,
                          const std::string& channel,
-                         const base::ListValue& args);
+                         const base::ListValue& args,
+                         uint64_t trace_id);
 
   // Called when received a synchronous message from renderer.
   void OnRendererMessageSync(content::RenderFrameHost* frame_host,
                              bool internal,
                              const std::string& channel,
                              const base::ListValue& args,
+                             uint64_t trace_id,
                              IPC::Message* message);
 
   // Called when received a message from renderer to be forwarded.
@@ -493,12 +526,14 @@ class WebContents : public mate::TrackableObject<WebContents>,
                            bool send_to_all,
                            int32_t web_contents_id,
                            const std::string& channel,
-                           const base::ListValue& args);
+                           const base::ListValue& args,
+                           uint64_t trace_id);
 
   // Called when received a message from renderer to host.
   void OnRendererMessageHost(content::RenderFrameHost* frame_host,
                              const std::string& channel,
-                             const base::ListValue& args);
+                             const base::ListValue& args,
+                             uint64_t trace_id);
 
   // Called when received a synchronous message from renderer to
   // set temporary zoom level.
@@ -540,6 +575,11 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Whether to enable devtools.
   bool enable_devtools_ = true;
 
+#if BUILDFLAG(ENABLE_OSR)
+  // Whether paints are emitted as zero-copy frames.
+  bool zero_copy_paint_ = false;
+#endif
+
   // Observers of this WebContents.
   base::ObserverList<ExtendedWebContentsObserver> observers_;
 
@@ -4,13 +4,31 @@
 
 #include "atom/browser/api/frame_subscriber.h"
 
+#include <string.h>
+
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
+#include "base/memory/platform_shared_memory_region.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/render_widget_host_view.h"
-#include "ui/gfx/skbitmap_operations.h"
+#include "media/base/video_frame.h"
+#include "native_mate/dictionary.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#elif defined(OS_MACOSX)
+#include <mach/mach.h>
+#include <mach/mach_vm.h>
+#else
+#include <sys/mman.h>
+#endif
 
 #include "atom/common/node_includes.h"
 
@@ -18,16 +36,176 @@ namespace atom {
 
 namespace api {
 
-constexpr static int kMaxFrameRate = 30;
+namespace {
+
+// A copy-on-write mapping of a read-only shared memory region. Writing to it
+// only changes this process's copy of the pages written to, so it can back a
+// Buffer that scripts are free to modify.
+class PrivateMapping {
+ public:
+  static std::unique_ptr<PrivateMapping> Map(
+      base::ReadOnlySharedMemoryRegion region) {
+    auto platform_region =
+        base::ReadOnlySharedMemoryRegion::TakeHandleForSerialization(
+            std::move(region));
+    size_t size = platform_region.GetSize();
+    void* memory = nullptr;
+#if defined(OS_WIN)
+    memory = ::MapViewOfFile(platform_region.GetPlatformHandle(),
+                             FILE_MAP_COPY, 0, 0, size);
+#elif defined(OS_MACOSX)
+    mach_vm_address_t address = 0;
+    if (mach_vm_map(mach_task_self(), &address, size, 0, VM_FLAGS_ANYWHERE,
+                    platform_region.GetPlatformHandle(), 0, FALSE,
+                    VM_PROT_READ, VM_PROT_READ,
+                    VM_INHERIT_NONE) != KERN_SUCCESS)
+      return nullptr;
+    // The memory entry is read-only, VM_PROT_COPY still allows writing by
+    // giving the pages copy-on-write semantics.
+    if (mach_vm_protect(mach_task_self(), address, size, FALSE,
+                        VM_PROT_READ | VM_PROT_WRITE | VM_PROT_COPY) !=
+        KERN_SUCCESS) {
+      mach_vm_deallocate(mach_task_self(), address, size);
+      return nullptr;
+    }
+    memory = reinterpret_cast<void*>(address);
+#else
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                  platform_region.GetPlatformHandle(), 0);
+    if (memory == MAP_FAILED)
+      memory = nullptr;
+#endif
+    if (!memory)
+      return nullptr;
+    return base::WrapUnique(new PrivateMapping(memory, size));
+  }
+
+  ~PrivateMapping() {
+#if defined(OS_WIN)
+    ::UnmapViewOfFile(memory_);
+#elif defined(OS_MACOSX)
+    mach_vm_deallocate(mach_task_self(),
+                       reinterpret_cast<mach_vm_address_t>(memory_), size_);
+#else
+    munmap(memory_, size_);
+#endif
+  }
+
+  char* memory() const { return static_cast<char*>(memory_); }
+
+ private:
+  PrivateMapping(void* memory, size_t size) : memory_(memory), size_(size) {}
+
+  void* memory_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrivateMapping);
+};
+
+// Keeps the shared memory of a captured frame mapped, and stops the capturer
+// from recycling it, until the frame is released.
+class CapturedFrame : public base::RefCounted<CapturedFrame> {
+ public:
+  CapturedFrame(base::ReadOnlySharedMemoryMapping mapping,
+                viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr callbacks)
+      : mapping_(std::move(mapping)), callbacks_(std::move(callbacks)) {}
+
+  CapturedFrame(std::unique_ptr<PrivateMapping> private_mapping,
+                viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr callbacks)
+      : private_mapping_(std::move(private_mapping)),
+        callbacks_(std::move(callbacks)) {}
+
+  const char* data() const {
+    if (private_mapping_)
+      return private_mapping_->memory();
+    return static_cast<const char*>(mapping_.memory());
+  }
+
+  // Wraps |size| bytes of the private mapping starting at |offset| in a Buffer
+  // without copying them.
+  v8::Local<v8::Object> CreateExternalBuffer(v8::Isolate* isolate,
+                                             size_t offset,
+                                             size_t size) {
+    DCHECK(private_mapping_);
+    // Balanced in OnBufferFreed.
+    AddRef();
+    auto buffer =
+        node::Buffer::New(isolate, private_mapping_->memory() + offset, size,
+                          &OnBufferFreed, this)
+            .ToLocalChecked();
+    buffer_.Reset(isolate, buffer);
+    buffer_.SetWeak();
+    return buffer;
+  }
+
+  // Detaches the buffer from the mapping so the frame can be returned to the
+  // capturer before the buffer is garbage collected.
+  void ReleaseFrame(v8::Isolate* isolate) {
+    if (!buffer_.IsEmpty()) {
+      v8::HandleScope handle_scope(isolate);
+      auto array_buffer = buffer_.Get(isolate).As<v8::Uint8Array>()->Buffer();
+      // The mapping has to outlive a buffer that can not be detached, the
+      // frame is returned once it is garbage collected.
+      if (!array_buffer->IsNeuterable())
+        return;
+      array_buffer->Neuter();
+    }
+    Unpin();
+  }
+
+  // Returns the frame to the capturer.
+  void Unpin() {
+    mapping_ = base::ReadOnlySharedMemoryMapping();
+    private_mapping_.reset();
+    callbacks_.reset();
+  }
+
+ private:
+  friend class base::RefCounted<CapturedFrame>;
+  ~CapturedFrame() = default;
+
+  static void OnBufferFreed(char* data, void* hint) {
+    auto* self = static_cast<CapturedFrame*>(hint);
+    self->Unpin();
+    self->Release();
+  }
+
+  base::ReadOnlySharedMemoryMapping mapping_;
+  std::unique_ptr<PrivateMapping> private_mapping_;
+  viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr callbacks_;
+  v8::Global<v8::Object> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(CapturedFrame);
+};
+
+// Copies |rows| rows of |row_size| bytes, which are |stride| bytes apart in
+// |source|, into a tightly packed Buffer.
+v8::Local<v8::Object> CopyRows(v8::Isolate* isolate,
+                               const char* source,
+                               size_t stride,
+                               size_t row_size,
+                               int rows) {
+  if (stride == row_size)
+    return node::Buffer::Copy(isolate, source, row_size * rows)
+        .ToLocalChecked();
+
+  auto buffer = node::Buffer::New(isolate, row_size * rows).ToLocalChecked();
+  char* dest = node::Buffer::Data(buffer);
+  for (int y = 0; y < rows; ++y)
+    memcpy(dest + y * row_size, source + y * stride, row_size);
+  return buffer;
+}
+
+}  // namespace
 
 FrameSubscriber::FrameSubscriber(v8::Isolate* isolate,
                                  content::WebContents* web_contents,
                                  const FrameCaptureCallback& callback,
-                                 bool only_dirty)
+                                 const FrameSubscriberOptions& options)
     : content::WebContentsObserver(web_contents),
       isolate_(isolate),
       callback_(callback),
-      only_dirty_(only_dirty),
+      options_(options),
       weak_ptr_factory_(this) {
   content::RenderViewHost* rvh = web_contents->GetRenderViewHost();
   if (rvh)
@@ -46,15 +224,13 @@ void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
 
   // Create and configure the video capturer.
   video_capturer_ = host_->GetView()->CreateVideoCapturer();
-  video_capturer_->SetResolutionConstraints(
-      host_->GetView()->GetViewBounds().size(),
-      host_->GetView()->GetViewBounds().size(), true);
+  video_capturer_->SetResolutionConstraints(GetCaptureSize(),
+                                            GetCaptureSize(), true);
   video_capturer_->SetAutoThrottlingEnabled(false);
   video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
-  video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB,
-                             gfx::ColorSpace::CreateREC709());
+  video_capturer_->SetFormat(options_.format, gfx::ColorSpace::CreateREC709());
   video_capturer_->SetMinCapturePeriod(base::TimeDelta::FromSeconds(1) /
-                                       kMaxFrameRate);
+                                       options_.max_frame_rate);
   video_capturer_->Start(this);
 }
 
@@ -90,85 +266,129 @@ void FrameSubscriber::OnFrameCaptured(
     const gfx::Rect& update_rect,
     const gfx::Rect& content_rect,
     viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr callbacks) {
-  gfx::Size view_size = host_->GetView()->GetViewBounds().size();
-  if (view_size != content_rect.size()) {
-    video_capturer_->SetResolutionConstraints(view_size, view_size, true);
-    video_capturer_->RequestRefreshFrame();
-    return;
+  // Follow the view's size unless a fixed size was requested.
+  if (options_.size.IsEmpty()) {
+    gfx::Size view_size = host_->GetView()->GetViewBounds().size();
+    if (view_size != content_rect.size()) {
+      video_capturer_->SetResolutionConstraints(view_size, view_size, true);
+      video_capturer_->RequestRefreshFrame();
+      return;
+    }
   }
 
   if (!data.IsValid()) {
     callbacks->Done();
     return;
   }
-  base::ReadOnlySharedMemoryMapping mapping = data.Map();
-  if (!mapping.IsValid()) {
-    DLOG(ERROR) << "Shared memory mapping failed.";
-    return;
-  }
-  if (mapping.size() <
-      media::VideoFrame::AllocationSize(info->pixel_format, info->coded_size)) {
+  size_t frame_size =
+      media::VideoFrame::AllocationSize(info->pixel_format, info->coded_size);
+  if (data.GetSize() < frame_size) {
     DLOG(ERROR) << "Shared memory size was less than expected.";
     return;
   }
-
-  // The SkBitmap's pixels will be marked as immutable, but the installPixels()
-  // API requires a non-const pointer. So, cast away the const.
-  void* const pixels = const_cast<void*>(mapping.memory());
-
-  // Call installPixels() with a |releaseProc| that: 1) notifies the capturer
-  // that this consumer has finished with the frame, and 2) releases the shared
-  // memory mapping.
-  struct FramePinner {
-    // Keeps the shared memory that backs |frame_| mapped.
-    base::ReadOnlySharedMemoryMapping mapping;
-    // Prevents FrameSinkVideoCapturer from recycling the shared memory that
-    // backs |frame_|.
-    viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr releaser;
-  };
-
-  SkBitmap bitmap;
-  bitmap.installPixels(
-      SkImageInfo::MakeN32(content_rect.width(), content_rect.height(),
-                           kPremul_SkAlphaType),
-      pixels,
-      media::VideoFrame::RowBytes(media::VideoFrame::kARGBPlane,
-                                  info->pixel_format, info->coded_size.width()),
-      [](void* addr, void* context) {
-        delete static_cast<FramePinner*>(context);
-      },
-      new FramePinner{std::move(mapping), std::move(callbacks)});
-  bitmap.setImmutable();
-
-  Done(content_rect, bitmap);
-}
-
-void FrameSubscriber::OnStopped() {}
-
-void FrameSubscriber::Done(const gfx::Rect& damage, const SkBitmap& frame) {
-  if (frame.drawsNothing())
+  if (content_rect.IsEmpty())
     return;
 
+  // The capturer's mapping is read-only, a Buffer pointing into it would crash
+  // the browser when written to. Without a private mapping the frame is
+  // copied instead.
+  std::unique_ptr<PrivateMapping> private_mapping;
+  if (options_.zero_copy)
+    private_mapping = PrivateMapping::Map(data.Duplicate());
+  bool zero_copy = !!private_mapping;
+
+  scoped_refptr<CapturedFrame> frame;
+  if (zero_copy) {
+    frame = base::MakeRefCounted<CapturedFrame>(std::move(private_mapping),
+                                                std::move(callbacks));
+  } else {
+    base::ReadOnlySharedMemoryMapping mapping = data.Map();
+    if (!mapping.IsValid()) {
+      DLOG(ERROR) << "Shared memory mapping failed.";
+      return;
+    }
+    frame = base::MakeRefCounted<CapturedFrame>(std::move(mapping),
+                                                std::move(callbacks));
+  }
+
   v8::Locker locker(isolate_);
   v8::HandleScope handle_scope(isolate_);
 
-  const_cast<SkBitmap&>(frame).setAlphaType(kPremul_SkAlphaType);
-  const SkBitmap& bitmap = only_dirty_ ? SkBitmapOperations::CreateTiledBitmap(
-                                             frame, damage.x(), damage.y(),
-                                             damage.width(), damage.height())
-                                       : frame;
-
-  size_t rgb_row_size = bitmap.width() * bitmap.bytesPerPixel();
-  auto* source = static_cast<const char*>(bitmap.getPixels());
+  v8::Local<v8::Object> buffer;
+  std::vector<size_t> strides;
+  std::vector<size_t> offsets;
+  gfx::Rect rect = content_rect;
+  if (info->pixel_format == media::PIXEL_FORMAT_I420) {
+    // The planes are laid out one after the other, hand them out as a whole.
+    size_t offset = 0;
+    for (size_t plane = 0; plane < media::VideoFrame::kMaxPlanes; ++plane) {
+      if (plane >= media::VideoFrame::NumPlanes(info->pixel_format))
+        break;
+      strides.push_back(media::VideoFrame::RowBytes(
+          plane, info->pixel_format, info->coded_size.width()));
+      offsets.push_back(offset);
+      offset += strides.back() * media::VideoFrame::Rows(
+                                     plane, info->pixel_format,
+                                     info->coded_size.height());
+    }
+    buffer = zero_copy
+                 ? frame->CreateExternalBuffer(isolate_, 0, frame_size)
+                 : node::Buffer::Copy(isolate_, frame->data(), frame_size)
+                       .ToLocalChecked();
+  } else {
+    if (options_.only_dirty)
+      rect.Intersect(update_rect);
+    if (!options_.region.IsEmpty())
+      rect.Intersect(options_.region + content_rect.OffsetFromOrigin());
+    if (rect.IsEmpty())
+      return;
+
+    size_t stride = media::VideoFrame::RowBytes(media::VideoFrame::kARGBPlane,
+                                                info->pixel_format,
+                                                info->coded_size.width());
+    size_t row_size = rect.width() * 4;
+    size_t offset = rect.y() * stride + rect.x() * 4;
+    if (zero_copy) {
+      // Rows keep the frame's stride, so the buffer only spans from the first
+      // pixel of the area to its last one.
+      buffer = frame->CreateExternalBuffer(
+          isolate_, offset, (rect.height() - 1) * stride + row_size);
+      strides.push_back(stride);
+    } else {
+      buffer = CopyRows(isolate_, frame->data() + offset, stride, row_size,
+                        rect.height());
+      strides.push_back(row_size);
+    }
+    offsets.push_back(0);
+  }
 
-  v8::MaybeLocal<v8::Object> buffer =
-      node::Buffer::Copy(isolate_, source, rgb_row_size * bitmap.height());
-  auto local_buffer = buffer.ToLocalChecked();
+  // The copied frames do not need the shared memory anymore.
+  if (!zero_copy)
+    frame->Unpin();
+
+  rect -= content_rect.OffsetFromOrigin();
+
+  mate::Dictionary frame_info = mate::Dictionary::CreateEmpty(isolate_);
+  frame_info.Set("format", info->pixel_format == media::PIXEL_FORMAT_I420
+                               ? "i420"
+                               : "bgra");
+  frame_info.Set("width", rect.width());
+  frame_info.Set("height", rect.height());
+  frame_info.Set("strides", strides);
+  frame_info.Set("offsets", offsets);
+  frame_info.Set("release",
+                 base::Bind(&CapturedFrame::ReleaseFrame, frame, isolate_));
+
+  callback_.Run(buffer, mate::ConvertToV8(isolate_, rect),
+                frame_info.GetHandle());
+}
 
-  v8::Local<v8::Value> damage_rect =
-      mate::Converter<gfx::Rect>::ToV8(isolate_, damage);
+void FrameSubscriber::OnStopped() {}
 
-  callback_.Run(local_buffer, damage_rect);
+gfx::Size FrameSubscriber::GetCaptureSize() const {
+  if (!options_.size.IsEmpty())
+    return options_.size;
+  return host_->GetView()->GetViewBounds().size();
 }
 
 }  // namespace api
@@ -12,6 +12,8 @@
 #include "components/viz/host/client_frame_sink_video_capturer.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_observer.h"
+#include "media/base/video_types.h"
+#include "ui/gfx/geometry/rect.h"
 #include "v8/include/v8.h"
 
 namespace atom {
@@ -20,16 +22,33 @@ namespace api {
 
 class WebContents;
 
+struct FrameSubscriberOptions {
+  // Only deliver the area of the frame that was repainted.
+  bool only_dirty = false;
+  int max_frame_rate = 30;
+  // Size the frames are captured at, empty to follow the view's size.
+  gfx::Size size;
+  // Area of the frame to deliver, empty for the whole frame. Only applies to
+  // ARGB frames.
+  gfx::Rect region;
+  // Either PIXEL_FORMAT_ARGB or PIXEL_FORMAT_I420.
+  media::VideoPixelFormat format = media::PIXEL_FORMAT_ARGB;
+  // Hand out the capturer's shared memory instead of copying the frames.
+  bool zero_copy = false;
+};
+
 class FrameSubscriber : public content::WebContentsObserver,
                         public viz::mojom::FrameSinkVideoConsumer {
  public:
-  using FrameCaptureCallback =
-      base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+  // Called with the frame's pixels, the area of the page they show and a
+  // description of their layout.
+  using FrameCaptureCallback = base::Callback<
+      void(v8::Local<v8::Value>, v8::Local<v8::Value>, v8::Local<v8::Value>)>;
 
   FrameSubscriber(v8::Isolate* isolate,
                   content::WebContents* web_contents,
                   const FrameCaptureCallback& callback,
-                  bool only_dirty);
+                  const FrameSubscriberOptions& options);
   ~FrameSubscriber() override;
 
  private:
@@ -50,11 +69,12 @@ class FrameSubscriber : public content::WebContentsObserver,
       viz::mojom::FrameSinkVideoConsumerFrameCallbacksPtr callbacks) override;
   void OnStopped() override;
 
-  void Done(const gfx::Rect& damage, const SkBitmap& frame);
+  // Size the capturer should produce frames at.
+  gfx::Size GetCaptureSize() const;
 
   v8::Isolate* isolate_;
   FrameCaptureCallback callback_;
-  bool only_dirty_;
+  FrameSubscriberOptions options_;
 
   content::RenderWidgetHost* host_;
   std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
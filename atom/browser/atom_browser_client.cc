@@ -22,6 +22,7 @@
 #include "atom/browser/atom_resource_dispatcher_host_delegate.h"
 #include "atom/browser/atom_speech_recognition_manager_delegate.h"
 #include "atom/browser/child_web_contents_tracker.h"
+#include "atom/browser/direct_channel_message_filter.h"
 #include "atom/browser/font_defaults.h"
 #include "atom/browser/io_thread.h"
 #include "atom/browser/media/media_capture_devices_dispatcher.h"
@@ -29,6 +30,7 @@
 #include "atom/browser/notifications/notification_presenter.h"
 #include "atom/browser/notifications/platform_notification_service.h"
 #include "atom/browser/session_preferences.h"
+#include "atom/browser/spare_renderer_pool.h"
 #include "atom/browser/ui/devtools_manager_delegate.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
@@ -323,6 +325,50 @@ void AtomBrowserClient::ConsiderSiteInstanceForAffinity(
   }
 }
 
+content::SiteInstance* AtomBrowserClient::GetSpareSiteInstance(
+    content::RenderFrameHost* current_rfh,
+    content::RenderFrameHost* speculative_rfh,
+    content::BrowserContext* browser_context,
+    const GURL& url) const {
+  auto* pool = SpareRendererPool::FromBrowserContext(browser_context);
+  if (!pool)
+    return nullptr;
+
+  // Only the first navigation of a window, which would otherwise launch a
+  // new renderer process, can use a spare one.
+  content::SiteInstance* current_instance = current_rfh->GetSiteInstance();
+  if (current_rfh->GetParent() || current_rfh->IsRenderFrameLive() ||
+      current_instance->HasSite())
+    return nullptr;
+
+  // The navigation is asked again before committing, by then it has a
+  // speculative frame in the spare SiteInstance it was given.
+  if (speculative_rfh) {
+    content::SiteInstance* speculative_instance =
+        speculative_rfh->GetSiteInstance();
+    if (current_instance->IsRelatedSiteInstance(speculative_instance))
+      return nullptr;
+    return speculative_instance;
+  }
+
+  // Windows opened by window.open() have to stay in the BrowsingInstance of
+  // their opener, and windows with affinity share their renderers.
+  auto* web_contents = content::WebContents::FromRenderFrameHost(current_rfh);
+  if (web_contents->HasOpener() ||
+      ChildWebContentsTracker::FromWebContents(web_contents) ||
+      !GetAffinityPreference(current_rfh).empty() ||
+      url.SchemeIs("chrome-devtools"))
+    return nullptr;
+
+  auto* web_preferences = WebContentsPreferences::From(web_contents);
+  if (!web_preferences)
+    return nullptr;
+
+  // The spare renderer is not locked to any site yet, the site of the
+  // navigation is assigned to it on commit like for a new renderer.
+  return pool->TakeSpare(web_preferences);
+}
+
 void AtomBrowserClient::RenderProcessWillLaunch(
     content::RenderProcessHost* host,
     service_manager::mojom::ServiceRequest* service_request) {
@@ -331,6 +377,8 @@ void AtomBrowserClient::RenderProcessWillLaunch(
   if (IsProcessObserved(process_id))
     return;
 
+  host->AddFilter(new DirectChannelMessageFilter(process_id));
+
 #if BUILDFLAG(ENABLE_PRINTING)
   host->AddFilter(new printing::PrintingMessageFilter(
       process_id, host->GetBrowserContext()));
@@ -343,6 +391,9 @@ void AtomBrowserClient::RenderProcessWillLaunch(
   ProcessPreferences prefs;
   auto* web_preferences =
       WebContentsPreferences::From(GetWebContentsFromProcessID(process_id));
+  // Spare renderers are launched before their WebContents exist.
+  if (!web_preferences)
+    web_preferences = SpareRendererPool::GetPreferencesForProcess(host);
   if (web_preferences) {
     prefs.sandbox = web_preferences->IsEnabled(options::kSandbox);
     prefs.native_window_open =
@@ -419,6 +470,14 @@ AtomBrowserClient::ShouldOverrideSiteInstanceForNavigation(
     return SiteInstanceForNavigationType::FORCE_AFFINITY;
   }
 
+  // Can a renderer launched ahead of time take the navigation?
+  content::SiteInstance* spare_site_instance = GetSpareSiteInstance(
+      current_rfh, speculative_rfh, browser_context, url);
+  if (spare_site_instance) {
+    *affinity_site_instance = spare_site_instance;
+    return SiteInstanceForNavigationType::FORCE_AFFINITY;
+  }
+
   if (!ShouldForceNewSiteInstance(current_rfh, speculative_rfh, browser_context,
                                   url, has_response_started)) {
     return SiteInstanceForNavigationType::ASK_CHROMIUM;
@@ -512,6 +571,15 @@ void AtomBrowserClient::AppendExtraCommandLineSwitches(
       web_preferences->AppendCommandLineSwitches(command_line);
     SessionPreferences::AppendExtraCommandLineSwitches(
         web_contents->GetBrowserContext(), command_line);
+  } else {
+    auto* host = content::RenderProcessHost::FromID(process_id);
+    auto* web_preferences =
+        host ? SpareRendererPool::GetPreferencesForProcess(host) : nullptr;
+    if (web_preferences) {
+      web_preferences->AppendCommandLineSwitches(command_line);
+      SessionPreferences::AppendExtraCommandLineSwitches(
+          host->GetBrowserContext(), command_line);
+    }
   }
 }
 
@@ -205,6 +205,11 @@ class AtomBrowserClient : public content::ContentBrowserClient,
       content::RenderFrameHost* rfh) const;
   void ConsiderSiteInstanceForAffinity(content::RenderFrameHost* rfh,
                                        content::SiteInstance* site_instance);
+  content::SiteInstance* GetSpareSiteInstance(
+      content::RenderFrameHost* current_rfh,
+      content::RenderFrameHost* speculative_rfh,
+      content::BrowserContext* browser_context,
+      const GURL& url) const;
 
   // pending_render_process => web contents.
   std::map<int, content::WebContents*> pending_processes_;
@@ -19,6 +19,7 @@
 #include "atom/browser/atom_web_ui_controller_factory.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/browser_process_impl.h"
+#include "atom/browser/gc_scheduler.h"
 #include "atom/browser/javascript_environment.h"
 #include "atom/browser/media/media_capture_devices_dispatcher.h"
 #include "atom/browser/node_debugger.h"
@@ -420,10 +421,12 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   ui::TouchFactory::SetTouchDeviceListFromCommandLine();
 #endif
 
-  // Start idle gc.
-  gc_timer_.Start(FROM_HERE, base::TimeDelta::FromMinutes(1),
-                  base::Bind(&v8::Isolate::LowMemoryNotification,
-                             base::Unretained(js_env_->isolate())));
+  // Collect garbage when idle or under memory pressure.
+  gc_scheduler_ = std::make_unique<GCScheduler>(
+      std::make_unique<IsolateGCDelegate>(js_env_->isolate(),
+                                          js_env_->platform()),
+      GCScheduler::GetOptionsFromCommandLine());
+  gc_scheduler_->Start();
 
   content::WebUIControllerFactory::RegisterFactory(
       AtomWebUIControllerFactory::GetInstance());
@@ -481,6 +484,7 @@ void AtomBrowserMainParts::PostMainMessageLoopRun() {
   ui::SetX11ErrorHandlers(X11EmptyErrorHandler, X11EmptyIOErrorHandler);
 #endif
 
+  gc_scheduler_.reset();
   js_env_->OnMessageLoopDestroying();
 
 #if defined(OS_MACOSX)
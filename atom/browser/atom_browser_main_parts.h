@@ -10,7 +10,6 @@
 #include <string>
 
 #include "base/callback.h"
-#include "base/timer/timer.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_main_parts.h"
 #include "content/public/common/main_function_params.h"
@@ -30,6 +29,7 @@ namespace atom {
 
 class AtomBindings;
 class Browser;
+class GCScheduler;
 class JavascriptEnvironment;
 class NodeBindings;
 class NodeDebugger;
@@ -127,7 +127,7 @@ class AtomBrowserMainParts : public content::BrowserMainParts {
   std::unique_ptr<NodeDebugger> node_debugger_;
   std::unique_ptr<IconManager> icon_manager_;
 
-  base::RepeatingTimer gc_timer_;
+  std::unique_ptr<GCScheduler> gc_scheduler_;
 
   // List of callbacks should be executed before destroying JS env.
   std::list<base::OnceClosure> destructors_;
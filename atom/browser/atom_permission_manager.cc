@@ -5,11 +5,15 @@
 #include "atom/browser/atom_permission_manager.h"
 
 #include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/web_contents_preferences.h"
+#include "base/json/json_writer.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "content/public/browser/permission_controller.h"
 #include "content/public/browser/permission_type.h"
@@ -31,6 +35,28 @@ bool WebContentsDestroyed(int process_id) {
   return web_contents->IsBeingDestroyed();
 }
 
+// Serializes the details a handler's decision may depend on. Decisions are
+// only reused for requests and checks with the same details, so a grant for
+// one external URL or media type does not apply to another.
+std::string GetDecisionScope(const base::DictionaryValue* details) {
+  if (!details)
+    return std::string();
+
+  base::DictionaryValue scope;
+  for (const char* key :
+       {"externalURL", "mediaTypes", "mediaType", "securityOrigin"}) {
+    const base::Value* value = details->FindKey(key);
+    if (value)
+      scope.SetKey(key, value->Clone());
+  }
+  if (scope.empty())
+    return std::string();
+
+  std::string json;
+  base::JSONWriter::Write(scope, &json);
+  return json;
+}
+
 void PermissionRequestResponseCallbackWrapper(
     const AtomPermissionManager::StatusCallback& callback,
     const std::vector<blink::mojom::PermissionStatus>& vector) {
@@ -84,6 +110,13 @@ class AtomPermissionManager::PendingRequest {
   size_t remaining_results_;
 };
 
+struct AtomPermissionManager::Subscription {
+  content::PermissionType permission;
+  GURL origin;
+  StatusCallback callback;
+  blink::mojom::PermissionStatus current_status;
+};
+
 AtomPermissionManager::AtomPermissionManager() {}
 
 AtomPermissionManager::~AtomPermissionManager() {}
@@ -100,11 +133,21 @@ void AtomPermissionManager::SetPermissionRequestHandler(
     pending_requests_.Clear();
   }
   request_handler_ = handler;
+  // The cached decisions came from the previous handler.
+  request_decisions_.clear();
+  NotifyStatusChanges();
 }
 
 void AtomPermissionManager::SetPermissionCheckHandler(
     const CheckHandler& handler) {
   check_handler_ = handler;
+  check_decisions_.clear();
+}
+
+void AtomPermissionManager::ClearPermissionDecisions() {
+  request_decisions_.clear();
+  check_decisions_.clear();
+  NotifyStatusChanges();
 }
 
 int AtomPermissionManager::RequestPermission(
@@ -173,16 +216,45 @@ int AtomPermissionManager::RequestPermissionsWithDetails(
     return content::PermissionController::kNoPendingOperation;
   }
 
+  // Answer from the cached decisions when possible.
+  GURL origin = requesting_origin.GetOrigin();
+  std::string scope = GetDecisionScope(details);
+  std::vector<blink::mojom::PermissionStatus> cached(permissions.size());
+  std::vector<bool> is_cached(permissions.size(), false);
+  size_t cached_count = 0;
+  for (size_t i = 0; i < permissions.size(); ++i) {
+    if (LookupDecision(&request_decisions_, permissions[i], origin, scope,
+                       &cached[i])) {
+      is_cached[i] = true;
+      ++cached_count;
+    }
+  }
+  if (cached_count == permissions.size()) {
+    PendingRequest request(render_frame_host, permissions, response_callback);
+    for (size_t i = 0; i < permissions.size(); ++i)
+      request.SetPermissionStatus(i, cached[i]);
+    request.RunCallback();
+    return content::PermissionController::kNoPendingOperation;
+  }
+
   auto* web_contents =
       content::WebContents::FromRenderFrameHost(render_frame_host);
-  int request_id = pending_requests_.Add(std::make_unique<PendingRequest>(
-      render_frame_host, permissions, response_callback));
+  auto pending_request = std::make_unique<PendingRequest>(
+      render_frame_host, permissions, response_callback);
+  for (size_t i = 0; i < permissions.size(); ++i) {
+    if (is_cached[i])
+      pending_request->SetPermissionStatus(i, cached[i]);
+  }
+  int request_id = pending_requests_.Add(std::move(pending_request));
 
   for (size_t i = 0; i < permissions.size(); ++i) {
+    if (is_cached[i])
+      continue;
     auto permission = permissions[i];
     const auto callback =
-        base::Bind(&AtomPermissionManager::OnPermissionResponse,
-                   base::Unretained(this), request_id, i);
+        base::Bind(&AtomPermissionManager::OnPermissionDecision,
+                   base::Unretained(this), request_id, i, permission, origin,
+                   scope);
     if (details == nullptr) {
       request_handler_.Run(web_contents, permission, callback,
                            base::DictionaryValue());
@@ -209,15 +281,37 @@ void AtomPermissionManager::OnPermissionResponse(
   }
 }
 
+void AtomPermissionManager::OnPermissionDecision(
+    int request_id,
+    int permission_id,
+    content::PermissionType permission,
+    const GURL& origin,
+    const std::string& scope,
+    const Decision& decision) {
+  if (decision.cache) {
+    CacheDecision(&request_decisions_, permission, origin, scope, decision);
+    NotifyStatusChanges();
+  }
+  OnPermissionResponse(request_id, permission_id,
+                       decision.granted
+                           ? blink::mojom::PermissionStatus::GRANTED
+                           : blink::mojom::PermissionStatus::DENIED);
+}
+
 void AtomPermissionManager::ResetPermission(content::PermissionType permission,
                                             const GURL& requesting_origin,
-                                            const GURL& embedding_origin) {}
+                                            const GURL& embedding_origin) {
+  GURL origin = requesting_origin.GetOrigin();
+  EraseDecisions(&request_decisions_, permission, origin);
+  EraseDecisions(&check_decisions_, permission, origin);
+  NotifyStatusChanges();
+}
 
 blink::mojom::PermissionStatus AtomPermissionManager::GetPermissionStatus(
     content::PermissionType permission,
     const GURL& requesting_origin,
     const GURL& embedding_origin) {
-  return blink::mojom::PermissionStatus::GRANTED;
+  return GetStatus(permission, requesting_origin.GetOrigin());
 }
 
 int AtomPermissionManager::SubscribePermissionStatusChange(
@@ -225,24 +319,42 @@ int AtomPermissionManager::SubscribePermissionStatusChange(
     content::RenderFrameHost* render_frame_host,
     const GURL& requesting_origin,
     const base::Callback<void(blink::mojom::PermissionStatus)>& callback) {
-  return -1;
+  GURL origin = requesting_origin.GetOrigin();
+  auto subscription = std::make_unique<Subscription>();
+  subscription->permission = permission;
+  subscription->origin = origin;
+  subscription->callback = callback;
+  subscription->current_status = GetStatus(permission, origin);
+  return subscriptions_.Add(std::move(subscription));
 }
 
 void AtomPermissionManager::UnsubscribePermissionStatusChange(
-    int subscription_id) {}
+    int subscription_id) {
+  subscriptions_.Remove(subscription_id);
+}
 
 bool AtomPermissionManager::CheckPermissionWithDetails(
     content::PermissionType permission,
     content::RenderFrameHost* render_frame_host,
     const GURL& requesting_origin,
-    const base::DictionaryValue* details) const {
+    const base::DictionaryValue* details) {
   if (check_handler_.is_null()) {
     return true;
   }
+
+  GURL origin = requesting_origin.GetOrigin();
+  std::string scope = GetDecisionScope(details);
+  blink::mojom::PermissionStatus status;
+  if (LookupDecision(&check_decisions_, permission, origin, scope, &status))
+    return status == blink::mojom::PermissionStatus::GRANTED;
+
   auto* web_contents =
       content::WebContents::FromRenderFrameHost(render_frame_host);
-  return check_handler_.Run(web_contents, permission, requesting_origin,
-                            *details);
+  Decision decision = check_handler_.Run(web_contents, permission,
+                                         requesting_origin, *details);
+  if (decision.cache)
+    CacheDecision(&check_decisions_, permission, origin, scope, decision);
+  return decision.granted;
 }
 
 blink::mojom::PermissionStatus
@@ -250,7 +362,71 @@ AtomPermissionManager::GetPermissionStatusForFrame(
     content::PermissionType permission,
     content::RenderFrameHost* render_frame_host,
     const GURL& requesting_origin) {
+  return GetStatus(permission, requesting_origin.GetOrigin());
+}
+
+bool AtomPermissionManager::LookupDecision(
+    DecisionsMap* decisions,
+    content::PermissionType permission,
+    const GURL& origin,
+    const std::string& scope,
+    blink::mojom::PermissionStatus* status) {
+  auto it = decisions->find(DecisionKey(permission, origin, scope));
+  if (it == decisions->end())
+    return false;
+  if (!it->second.expiry.is_null() &&
+      it->second.expiry <= base::TimeTicks::Now()) {
+    decisions->erase(it);
+    return false;
+  }
+  *status = it->second.status;
+  return true;
+}
+
+void AtomPermissionManager::CacheDecision(DecisionsMap* decisions,
+                                          content::PermissionType permission,
+                                          const GURL& origin,
+                                          const std::string& scope,
+                                          const Decision& decision) {
+  CachedDecision cached;
+  cached.status = decision.granted ? blink::mojom::PermissionStatus::GRANTED
+                                   : blink::mojom::PermissionStatus::DENIED;
+  if (!decision.ttl.is_zero())
+    cached.expiry = base::TimeTicks::Now() + decision.ttl;
+  (*decisions)[DecisionKey(permission, origin, scope)] = cached;
+}
+
+void AtomPermissionManager::EraseDecisions(DecisionsMap* decisions,
+                                           content::PermissionType permission,
+                                           const GURL& origin) {
+  auto it = decisions->lower_bound(DecisionKey(permission, origin, ""));
+  while (it != decisions->end() && std::get<0>(it->first) == permission &&
+         std::get<1>(it->first) == origin)
+    it = decisions->erase(it);
+}
+
+blink::mojom::PermissionStatus AtomPermissionManager::GetStatus(
+    content::PermissionType permission,
+    const GURL& origin) {
+  // The status of permissions whose requests come with details, like media
+  // access, is not tied to a single decision.
+  blink::mojom::PermissionStatus status;
+  if (LookupDecision(&request_decisions_, permission, origin, std::string(),
+                     &status))
+    return status;
   return blink::mojom::PermissionStatus::GRANTED;
 }
 
+void AtomPermissionManager::NotifyStatusChanges() {
+  for (SubscriptionsMap::iterator iter(&subscriptions_); !iter.IsAtEnd();
+       iter.Advance()) {
+    Subscription* subscription = iter.GetCurrentValue();
+    auto status = GetStatus(subscription->permission, subscription->origin);
+    if (status == subscription->current_status)
+      continue;
+    subscription->current_status = status;
+    subscription->callback.Run(status);
+  }
+}
+
 }  // namespace atom
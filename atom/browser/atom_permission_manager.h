@@ -7,12 +7,16 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include "base/callback.h"
 #include "base/containers/id_map.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/permission_controller_delegate.h"
+#include "url/gurl.h"
 
 namespace content {
 class WebContents;
@@ -28,19 +32,36 @@ class AtomPermissionManager : public content::PermissionControllerDelegate {
   using StatusCallback = base::Callback<void(blink::mojom::PermissionStatus)>;
   using StatusesCallback =
       base::Callback<void(const std::vector<blink::mojom::PermissionStatus>&)>;
+
+  // The verdict of a permission handler.
+  struct Decision {
+    bool granted = false;
+    // Whether the verdict applies to the later checks or requests of the same
+    // permission from the same origin, with the same details that matter to
+    // the verdict, without asking the handler again.
+    bool cache = false;
+    // How long a cached verdict stays valid, zero for as long as the handler
+    // is set.
+    base::TimeDelta ttl;
+  };
+  using DecisionCallback = base::Callback<void(const Decision&)>;
+
   using RequestHandler = base::Callback<void(content::WebContents*,
                                              content::PermissionType,
-                                             const StatusCallback&,
+                                             const DecisionCallback&,
                                              const base::DictionaryValue&)>;
-  using CheckHandler = base::Callback<bool(content::WebContents*,
-                                           content::PermissionType,
-                                           const GURL& requesting_origin,
-                                           const base::DictionaryValue&)>;
+  using CheckHandler = base::Callback<Decision(content::WebContents*,
+                                               content::PermissionType,
+                                               const GURL& requesting_origin,
+                                               const base::DictionaryValue&)>;
 
   // Handler to dispatch permission requests in JS.
   void SetPermissionRequestHandler(const RequestHandler& handler);
   void SetPermissionCheckHandler(const CheckHandler& handler);
 
+  // Forgets the verdicts cached for the handlers.
+  void ClearPermissionDecisions();
+
   // content::PermissionControllerDelegate:
   int RequestPermission(
       content::PermissionType permission,
@@ -79,12 +100,18 @@ class AtomPermissionManager : public content::PermissionControllerDelegate {
   bool CheckPermissionWithDetails(content::PermissionType permission,
                                   content::RenderFrameHost* render_frame_host,
                                   const GURL& requesting_origin,
-                                  const base::DictionaryValue* details) const;
+                                  const base::DictionaryValue* details);
 
  protected:
   void OnPermissionResponse(int request_id,
                             int permission_id,
                             blink::mojom::PermissionStatus status);
+  void OnPermissionDecision(int request_id,
+                            int permission_id,
+                            content::PermissionType permission,
+                            const GURL& origin,
+                            const std::string& scope,
+                            const Decision& decision);
 
   // content::PermissionControllerDelegate:
   void ResetPermission(content::PermissionType permission,
@@ -106,10 +133,51 @@ class AtomPermissionManager : public content::PermissionControllerDelegate {
   class PendingRequest;
   using PendingRequestsMap = base::IDMap<std::unique_ptr<PendingRequest>>;
 
+  struct Subscription;
+  using SubscriptionsMap = base::IDMap<std::unique_ptr<Subscription>>;
+
+  struct CachedDecision {
+    blink::mojom::PermissionStatus status;
+    // Null when the decision does not expire.
+    base::TimeTicks expiry;
+  };
+  // The permission, the requesting origin and the scope, which serializes the
+  // details a decision depends on, like the URL of an openExternal request.
+  using DecisionKey = std::tuple<content::PermissionType, GURL, std::string>;
+  using DecisionsMap = std::map<DecisionKey, CachedDecision>;
+
+  // Finds the unexpired decision cached in |decisions| for |permission| from
+  // |origin| in |scope|.
+  bool LookupDecision(DecisionsMap* decisions,
+                      content::PermissionType permission,
+                      const GURL& origin,
+                      const std::string& scope,
+                      blink::mojom::PermissionStatus* status);
+  void CacheDecision(DecisionsMap* decisions,
+                     content::PermissionType permission,
+                     const GURL& origin,
+                     const std::string& scope,
+                     const Decision& decision);
+  // Drops the decisions for |permission| from |origin| in every scope.
+  void EraseDecisions(DecisionsMap* decisions,
+                      content::PermissionType permission,
+                      const GURL& origin);
+
+  // The status the page sees for |permission|, which only differs from
+  // granted when the request handler cached a denial.
+  blink::mojom::PermissionStatus GetStatus(content::PermissionType permission,
+                                           const GURL& origin);
+  // Notifies the subscribers whose status changed.
+  void NotifyStatusChanges();
+
   RequestHandler request_handler_;
   CheckHandler check_handler_;
 
   PendingRequestsMap pending_requests_;
+  SubscriptionsMap subscriptions_;
+
+  DecisionsMap request_decisions_;
+  DecisionsMap check_decisions_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomPermissionManager);
 };
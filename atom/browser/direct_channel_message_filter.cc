@@ -0,0 +1,142 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/direct_channel_message_filter.h"
+
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "base/no_destructor.h"
+#include "base/trace_event/trace_event.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+using Endpoint = DirectChannelMessageFilter::Endpoint;
+
+// All members are only accessed on the IO thread.
+struct ChannelRegistry {
+  std::map<int, DirectChannelMessageFilter*> filters;
+  std::map<int32_t, std::pair<Endpoint, Endpoint>> channels;
+};
+
+ChannelRegistry& GetRegistry() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  static base::NoDestructor<ChannelRegistry> registry;
+  return *registry;
+}
+
+bool IsEndpoint(const Endpoint& endpoint, int render_process_id,
+                int routing_id) {
+  return endpoint.render_process_id == render_process_id &&
+         endpoint.routing_id == routing_id;
+}
+
+}  // namespace
+
+DirectChannelMessageFilter::DirectChannelMessageFilter(int render_process_id)
+    : BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {}
+
+DirectChannelMessageFilter::~DirectChannelMessageFilter() {}
+
+// static
+void DirectChannelMessageFilter::OpenChannel(int32_t channel_id,
+                                             const Endpoint& first,
+                                             const Endpoint& second) {
+  GetRegistry().channels[channel_id] = std::make_pair(first, second);
+}
+
+// static
+void DirectChannelMessageFilter::CloseChannel(int32_t channel_id) {
+  GetRegistry().channels.erase(channel_id);
+}
+
+// static
+void DirectChannelMessageFilter::CloseFrameChannels(int render_process_id,
+                                                    int routing_id) {
+  auto& channels = GetRegistry().channels;
+  for (auto it = channels.begin(); it != channels.end();) {
+    if (IsEndpoint(it->second.first, render_process_id, routing_id) ||
+        IsEndpoint(it->second.second, render_process_id, routing_id))
+      it = channels.erase(it);
+    else
+      ++it;
+  }
+}
+
+void DirectChannelMessageFilter::OnFilterAdded(IPC::Channel* channel) {
+  GetRegistry().filters[render_process_id_] = this;
+}
+
+void DirectChannelMessageFilter::OnChannelClosing() {
+  auto& registry = GetRegistry();
+  registry.filters.erase(render_process_id_);
+
+  // The channels with an endpoint in this process can never be used again.
+  for (auto it = registry.channels.begin(); it != registry.channels.end();) {
+    if (it->second.first.render_process_id == render_process_id_ ||
+        it->second.second.render_process_id == render_process_id_)
+      it = registry.channels.erase(it);
+    else
+      ++it;
+  }
+}
+
+bool DirectChannelMessageFilter::OnMessageReceived(
+    const IPC::Message& message) {
+  if (message.type() != AtomFrameHostMsg_Message_Direct::ID)
+    return false;
+
+  AtomFrameHostMsg_Message_Direct::Param params;
+  if (AtomFrameHostMsg_Message_Direct::Read(&message, &params)) {
+    OnDirectMessage(message.routing_id(), std::get<0>(params),
+                    std::get<1>(params), std::get<2>(params),
+                    std::get<3>(params));
+  }
+  return true;
+}
+
+void DirectChannelMessageFilter::OnDirectMessage(int routing_id,
+                                                 int32_t channel_id,
+                                                 const std::string& channel,
+                                                 const base::ListValue& args,
+                                                 uint64_t trace_id) {
+  TRACE_EVENT_WITH_FLOW1(
+      "electron.ipc", "DirectChannelMessageFilter::OnDirectMessage", trace_id,
+      TRACE_EVENT_FLAG_FLOW_IN, "channel", channel);
+  auto& registry = GetRegistry();
+  auto it = registry.channels.find(channel_id);
+  if (it == registry.channels.end())
+    return;
+
+  // Only the two frames that the channel connects are allowed to use it.
+  const Endpoint* sender;
+  const Endpoint* receiver;
+  if (IsEndpoint(it->second.first, render_process_id_, routing_id)) {
+    sender = &it->second.first;
+    receiver = &it->second.second;
+  } else if (IsEndpoint(it->second.second, render_process_id_, routing_id)) {
+    sender = &it->second.second;
+    receiver = &it->second.first;
+  } else {
+    return;
+  }
+
+  auto filter = registry.filters.find(receiver->render_process_id);
+  if (filter == registry.filters.end())
+    return;
+
+  filter->second->Send(new AtomFrameMsg_Message(
+      receiver->routing_id, false /* internal */, false /* send_to_all */,
+      channel, args, sender->web_contents_id));
+}
+
+}  // namespace atom
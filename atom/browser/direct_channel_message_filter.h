@@ -0,0 +1,63 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_DIRECT_CHANNEL_MESSAGE_FILTER_H_
+#define ATOM_BROWSER_DIRECT_CHANNEL_MESSAGE_FILTER_H_
+
+#include <string>
+
+#include "content/public/browser/browser_message_filter.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace atom {
+
+// Relays messages of direct channels between two renderer frames.
+//
+// A channel is set up once from the UI thread, afterwards the messages are
+// forwarded from the sender's IPC channel to the receiver's IPC channel on the
+// IO thread and never wait for the browser's main thread.
+class DirectChannelMessageFilter : public content::BrowserMessageFilter {
+ public:
+  struct Endpoint {
+    int render_process_id;
+    int routing_id;
+    int32_t web_contents_id;
+  };
+
+  explicit DirectChannelMessageFilter(int render_process_id);
+
+  // Register or unregister a channel, must be called on the IO thread.
+  static void OpenChannel(int32_t channel_id,
+                          const Endpoint& first,
+                          const Endpoint& second);
+  static void CloseChannel(int32_t channel_id);
+  // Unregister the channels that have the frame |routing_id| of
+  // |render_process_id| as an endpoint.
+  static void CloseFrameChannels(int render_process_id, int routing_id);
+
+  // content::BrowserMessageFilter:
+  void OnFilterAdded(IPC::Channel* channel) override;
+  void OnChannelClosing() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~DirectChannelMessageFilter() override;
+
+  void OnDirectMessage(int routing_id,
+                       int32_t channel_id,
+                       const std::string& channel,
+                       const base::ListValue& args,
+                       uint64_t trace_id);
+
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectChannelMessageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_DIRECT_CHANNEL_MESSAGE_FILTER_H_
@@ -0,0 +1,206 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/early_process_singleton.h"
+
+#include <string>
+
+#include "atom/browser/atom_paths.h"
+#include "atom/common/application_info.h"
+#include "atom/common/asar/archive.h"
+#include "atom/common/atom_command_line.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/no_destructor.h"
+#include "base/path_service.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+#if defined(OS_LINUX)
+#include "base/environment.h"
+#include "base/nix/xdg_util.h"
+#endif
+
+namespace atom {
+
+namespace {
+
+const char kSingleInstanceKey[] = "singleInstance";
+
+// The lock taken before the browser was initialized, waiting for the app.
+ProcessSingleton* g_process_singleton = nullptr;
+
+ProcessSingleton::NotificationCallback& GetNotificationCallback() {
+  static base::NoDestructor<ProcessSingleton::NotificationCallback> callback;
+  return *callback;
+}
+
+bool ForwardNotification(const base::CommandLine::StringVector& command_line,
+                         const base::FilePath& current_directory) {
+  // The socket is only listened to once the browser is ready, by which time
+  // the app has taken the lock.
+  auto& callback = GetNotificationCallback();
+  DCHECK(!callback.is_null());
+  return !callback.is_null() && callback.Run(command_line, current_directory);
+}
+
+base::FilePath GetResourcesPath() {
+  base::FilePath exec_path;
+  base::PathService::Get(base::FILE_EXE, &exec_path);
+#if defined(OS_MACOSX)
+  return exec_path.DirName().DirName().Append("Resources");
+#else
+  return exec_path.DirName().Append(FILE_PATH_LITERAL("resources"));
+#endif
+}
+
+// Reads the package.json of the app in |app_path|, which is either a
+// directory or an asar archive.
+std::unique_ptr<base::DictionaryValue> ReadPackageJsonFrom(
+    const base::FilePath& app_path) {
+  base::FilePath package_json(FILE_PATH_LITERAL("package.json"));
+
+  std::string contents;
+  if (!base::ReadFileToString(app_path.Append(package_json), &contents)) {
+    asar::Archive archive(app_path);
+    asar::Archive::FileInfo info;
+    if (!archive.Init() || !archive.GetFileInfo(package_json, &info) ||
+        !archive.ReadFile(info, &contents))
+      return nullptr;
+  }
+
+  return base::DictionaryValue::From(base::JSONReader::Read(contents));
+}
+
+// Returns the app the default app would load, found in the command line the
+// same way as default_app/main.ts does.
+base::FilePath GetAppPathFromCommandLine() {
+  const auto& argv = AtomCommandLine::argv();
+  bool next_arg_is_require = false;
+  for (size_t i = 1; i < argv.size(); ++i) {
+    const auto& arg = argv[i];
+    if (next_arg_is_require) {
+      next_arg_is_require = false;
+    } else if (arg == FILE_PATH_LITERAL("--require") ||
+               arg == FILE_PATH_LITERAL("-r")) {
+      next_arg_is_require = true;
+    } else if (base::StartsWith(arg, FILE_PATH_LITERAL("--app="),
+                                base::CompareCase::SENSITIVE)) {
+      return base::FilePath(arg.substr(6));
+    } else if (arg == FILE_PATH_LITERAL("--version") ||
+               arg == FILE_PATH_LITERAL("-v") ||
+               arg == FILE_PATH_LITERAL("--test-type=webdriver")) {
+      return base::FilePath();
+    } else if (!arg.empty() && arg[0] != FILE_PATH_LITERAL('-')) {
+      return base::FilePath(arg);
+    }
+  }
+  return base::FilePath();
+}
+
+// Reads the package.json of the app that is going to run, looking at the same
+// places as lib/browser/init.ts and, for the default app, default_app/main.ts.
+// |packaged| tells whether the app was found in the resources directory.
+std::unique_ptr<base::DictionaryValue> ReadPackageJson(bool* packaged) {
+  base::FilePath resources_path = GetResourcesPath();
+  for (const auto* name :
+       {FILE_PATH_LITERAL("app"), FILE_PATH_LITERAL("app.asar")}) {
+    auto package_json = ReadPackageJsonFrom(resources_path.Append(name));
+    if (package_json) {
+      *packaged = true;
+      return package_json;
+    }
+  }
+
+  *packaged = false;
+  base::FilePath app_path = GetAppPathFromCommandLine();
+  if (app_path.empty())
+    return nullptr;
+  return ReadPackageJsonFrom(base::MakeAbsoluteFilePath(app_path));
+}
+
+// Returns the default userData directory, which is computed the same way as in
+// lib/browser/init.ts and default_app/main.ts.
+base::FilePath GetUserDataPath(const base::DictionaryValue* package_json,
+                               bool packaged) {
+  std::string name;
+  if (package_json && (package_json->GetString("productName", &name) ||
+                       package_json->GetString("name", &name))) {
+    base::TrimWhitespaceASCII(name, base::TRIM_ALL, &name);
+  } else if (packaged) {
+    name = GetApplicationName();
+  } else {
+    // The default app keeps its own userData for apps without a name, which
+    // the app can not be expected to lock.
+    return base::FilePath();
+  }
+
+  base::FilePath app_data;
+#if defined(OS_LINUX)
+  // DIR_APP_DATA is only registered once the browser main parts are created.
+  std::unique_ptr<base::Environment> env(base::Environment::Create());
+  app_data = base::nix::GetXDGDirectory(
+      env.get(), base::nix::kXdgConfigHomeEnvVar, base::nix::kDotConfigDir);
+#else
+  if (!base::PathService::Get(DIR_APP_DATA, &app_data))
+    return base::FilePath();
+#endif
+  return app_data.Append(base::FilePath::FromUTF8Unsafe(name));
+}
+
+}  // namespace
+
+bool AcquireEarlySingleInstanceLock(const base::CommandLine& command_line) {
+  DCHECK(!g_process_singleton);
+
+  bool packaged = false;
+  std::unique_ptr<base::DictionaryValue> package_json =
+      ReadPackageJson(&packaged);
+  bool enabled = command_line.HasSwitch(switches::kEarlySingleInstance);
+  if (!enabled && package_json)
+    package_json->GetBoolean(kSingleInstanceKey, &enabled);
+  if (!enabled)
+    return true;
+
+  // Without the package.json of the app its userData directory is unknown,
+  // a lock taken elsewhere would not be the one the app asks for.
+  if (!package_json)
+    return true;
+
+  base::FilePath user_data_path =
+      GetUserDataPath(package_json.get(), packaged);
+  if (user_data_path.empty())
+    return true;
+
+  auto process_singleton = std::make_unique<ProcessSingleton>(
+      user_data_path, base::BindRepeating(&ForwardNotification));
+  switch (process_singleton->NotifyOtherProcessOrCreate()) {
+    case ProcessSingleton::NotifyResult::PROCESS_NOTIFIED:
+      return false;
+    case ProcessSingleton::NotifyResult::PROCESS_NONE:
+      g_process_singleton = process_singleton.release();
+      return true;
+    case ProcessSingleton::NotifyResult::LOCK_ERROR:
+    case ProcessSingleton::NotifyResult::PROFILE_IN_USE:
+    default:
+      // Leave it to app.requestSingleInstanceLock() to report the failure.
+      return true;
+  }
+}
+
+std::unique_ptr<ProcessSingleton> TakeEarlySingleInstanceLock(
+    const ProcessSingleton::NotificationCallback& callback) {
+  if (!g_process_singleton)
+    return nullptr;
+  GetNotificationCallback() = callback;
+  std::unique_ptr<ProcessSingleton> process_singleton(g_process_singleton);
+  g_process_singleton = nullptr;
+  return process_singleton;
+}
+
+}  // namespace atom
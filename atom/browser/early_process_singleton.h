@@ -0,0 +1,36 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EARLY_PROCESS_SINGLETON_H_
+#define ATOM_BROWSER_EARLY_PROCESS_SINGLETON_H_
+
+#include <memory>
+
+#include "chrome/browser/process_singleton.h"
+
+namespace base {
+class CommandLine;
+}
+
+namespace atom {
+
+// Tries to take the single instance lock before the browser is initialized,
+// when the app opted in with the "singleInstance" field of its package.json or
+// the --early-single-instance switch. The lock lives in the app's default
+// userData directory, nothing is locked when the package.json of the app, or
+// the name of an app run by the default app, can not be found.
+//
+// Returns false when another instance has been handed the command line, in
+// which case the current process should exit right away.
+bool AcquireEarlySingleInstanceLock(const base::CommandLine& command_line);
+
+// Returns the lock taken by AcquireEarlySingleInstanceLock, or nullptr when
+// there is none. The command lines of later instances are passed to
+// |callback|, which must be set before the browser is ready.
+std::unique_ptr<ProcessSingleton> TakeEarlySingleInstanceLock(
+    const ProcessSingleton::NotificationCallback& callback);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_EARLY_PROCESS_SINGLETON_H_
@@ -0,0 +1,175 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/gc_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "v8/include/v8-platform.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+namespace {
+
+// Idle checks are never spaced out further than this.
+constexpr base::TimeDelta kMaxIdleCheckDelay = base::TimeDelta::FromMinutes(1);
+
+// Reads |switch_name| as a non-negative integer.
+bool GetIntSwitch(const base::CommandLine* command_line,
+                  const char* switch_name,
+                  int* value) {
+  return command_line->HasSwitch(switch_name) &&
+         base::StringToInt(command_line->GetSwitchValueASCII(switch_name),
+                           value) &&
+         *value >= 0;
+}
+
+}  // namespace
+
+// static
+GCScheduler::Options GCScheduler::GetOptionsFromCommandLine() {
+  auto* command_line = base::CommandLine::ForCurrentProcess();
+  Options options;
+  int value = 0;
+  if (GetIntSwitch(command_line, switches::kGCIdleDelay, &value) && value > 0)
+    options.idle_delay = base::TimeDelta::FromMilliseconds(value);
+  if (GetIntSwitch(command_line, switches::kGCIdleTime, &value) && value > 0)
+    options.idle_time = base::TimeDelta::FromMilliseconds(value);
+  if (GetIntSwitch(command_line, switches::kGCMinHeapGrowth, &value))
+    options.min_heap_growth = static_cast<size_t>(value) * 1024 * 1024;
+  return options;
+}
+
+GCScheduler::GCScheduler(std::unique_ptr<Delegate> delegate,
+                         const Options& options,
+                         const base::TickClock* clock)
+    : delegate_(std::move(delegate)),
+      options_(options),
+      clock_(clock),
+      idle_timer_(clock),
+      idle_check_delay_(options.idle_delay) {}
+
+GCScheduler::~GCScheduler() {
+  if (memory_pressure_listener_)
+    base::MessageLoopCurrent::Get()->RemoveTaskObserver(this);
+}
+
+void GCScheduler::Start() {
+  base::MessageLoopCurrent::Get()->AddTaskObserver(this);
+  memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+      base::BindRepeating(&GCScheduler::OnMemoryPressure,
+                          base::Unretained(this)));
+
+  last_task_time_ = clock_->NowTicks();
+  heap_size_after_gc_ = delegate_->GetUsedHeapSize();
+  ScheduleIdleCheck(options_.idle_delay);
+}
+
+void GCScheduler::WillProcessTask(const base::PendingTask& pending_task) {}
+
+void GCScheduler::DidProcessTask(const base::PendingTask& pending_task) {
+  // The idle checks must not count as activity themselves.
+  if (in_idle_check_) {
+    in_idle_check_ = false;
+    return;
+  }
+  last_task_time_ = clock_->NowTicks();
+}
+
+void GCScheduler::ScheduleIdleCheck(base::TimeDelta delay) {
+  idle_timer_.Start(
+      FROM_HERE, delay,
+      base::BindOnce(&GCScheduler::OnIdleCheck, base::Unretained(this)));
+}
+
+void GCScheduler::OnIdleCheck() {
+  in_idle_check_ = true;
+
+  base::TimeDelta quiet_time = clock_->NowTicks() - last_task_time_;
+  if (quiet_time < options_.idle_delay) {
+    // The loop has been busy, wait until it has been quiet for long enough.
+    idle_check_delay_ = options_.idle_delay;
+    ScheduleIdleCheck(options_.idle_delay - quiet_time);
+    return;
+  }
+
+  if (HasHeapGrownBy(options_.min_heap_growth)) {
+    TRACE_EVENT0("electron", "GCScheduler::NotifyIdle");
+    if (!delegate_->NotifyIdle(options_.idle_time)) {
+      // V8 has more work to do, give it another slice while still idle.
+      ScheduleIdleCheck(options_.idle_time);
+      return;
+    }
+    RecordCollection();
+    idle_check_delay_ = options_.idle_delay;
+  } else {
+    idle_check_delay_ = std::min(idle_check_delay_ * 2, kMaxIdleCheckDelay);
+  }
+  ScheduleIdleCheck(idle_check_delay_);
+}
+
+void GCScheduler::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  // Under critical pressure any garbage is worth collecting, under moderate
+  // pressure only a heap that grew enough is.
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      return;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      if (!HasHeapGrownBy(options_.min_heap_growth))
+        return;
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      if (!HasHeapGrownBy(1))
+        return;
+      break;
+  }
+
+  TRACE_EVENT1("electron", "GCScheduler::NotifyLowMemory", "level",
+               static_cast<int>(level));
+  delegate_->NotifyLowMemory();
+  RecordCollection();
+}
+
+bool GCScheduler::HasHeapGrownBy(size_t size) {
+  size_t used = delegate_->GetUsedHeapSize();
+  // The heap may also have shrunk from V8's own collections.
+  heap_size_after_gc_ = std::min(heap_size_after_gc_, used);
+  return used - heap_size_after_gc_ >= size;
+}
+
+void GCScheduler::RecordCollection() {
+  heap_size_after_gc_ = delegate_->GetUsedHeapSize();
+}
+
+IsolateGCDelegate::IsolateGCDelegate(v8::Isolate* isolate,
+                                     v8::Platform* platform)
+    : isolate_(isolate), platform_(platform) {}
+
+IsolateGCDelegate::~IsolateGCDelegate() = default;
+
+size_t IsolateGCDelegate::GetUsedHeapSize() {
+  v8::HeapStatistics stats;
+  isolate_->GetHeapStatistics(&stats);
+  return stats.used_heap_size();
+}
+
+bool IsolateGCDelegate::NotifyIdle(base::TimeDelta idle_time) {
+  // The deadline is relative to the platform's clock.
+  return isolate_->IdleNotificationDeadline(
+      platform_->MonotonicallyIncreasingTime() + idle_time.InSecondsF());
+}
+
+void IsolateGCDelegate::NotifyLowMemory() {
+  isolate_->LowMemoryNotification();
+}
+
+}  // namespace atom
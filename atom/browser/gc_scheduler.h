@@ -0,0 +1,121 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_GC_SCHEDULER_H_
+#define ATOM_BROWSER_GC_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/message_loop/message_loop_current.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace v8 {
+class Isolate;
+class Platform;
+}  // namespace v8
+
+namespace atom {
+
+// Schedules the garbage collections of the browser process's heap: V8 gets
+// idle time while the message loop has been quiet for a while, and full
+// collections are only forced under memory pressure. Collections are skipped
+// while the heap has not grown enough since the last one.
+class GCScheduler : public base::MessageLoopCurrent::TaskObserver {
+ public:
+  // The heap the scheduler works on.
+  class Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    virtual size_t GetUsedHeapSize() = 0;
+    // Lets V8 collect garbage for up to |idle_time|, returns true when it has
+    // no more idle work to do.
+    virtual bool NotifyIdle(base::TimeDelta idle_time) = 0;
+    // Forces a full, compacting collection.
+    virtual void NotifyLowMemory() = 0;
+  };
+
+  struct Options {
+    // How long the message loop must go without running a task before it is
+    // considered idle.
+    base::TimeDelta idle_delay = base::TimeDelta::FromSeconds(1);
+    // How long V8 may spend collecting garbage per idle notification.
+    base::TimeDelta idle_time = base::TimeDelta::FromMilliseconds(50);
+    // How much the heap must grow after a collection before the next one.
+    size_t min_heap_growth = 8 * 1024 * 1024;
+  };
+
+  // Reads the options from the --gc-idle-delay, --gc-idle-time and
+  // --gc-min-heap-growth switches.
+  static Options GetOptionsFromCommandLine();
+
+  GCScheduler(std::unique_ptr<Delegate> delegate,
+              const Options& options,
+              const base::TickClock* clock =
+                  base::DefaultTickClock::GetInstance());
+  ~GCScheduler() override;
+
+  // Starts watching the current message loop and the memory pressure.
+  void Start();
+
+  // base::MessageLoopCurrent::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+ private:
+  void ScheduleIdleCheck(base::TimeDelta delay);
+  void OnIdleCheck();
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Whether the heap grew by at least |size| since the last collection.
+  bool HasHeapGrownBy(size_t size);
+  void RecordCollection();
+
+  std::unique_ptr<Delegate> delegate_;
+  Options options_;
+  const base::TickClock* clock_;
+
+  base::OneShotTimer idle_timer_;
+  // Checks are spaced out further each time the loop is found idle with
+  // nothing to collect.
+  base::TimeDelta idle_check_delay_;
+  // The end of the last task which was not an idle check.
+  base::TimeTicks last_task_time_;
+  bool in_idle_check_ = false;
+
+  size_t heap_size_after_gc_ = 0;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  DISALLOW_COPY_AND_ASSIGN(GCScheduler);
+};
+
+// Collects the garbage of a V8 isolate.
+class IsolateGCDelegate : public GCScheduler::Delegate {
+ public:
+  IsolateGCDelegate(v8::Isolate* isolate, v8::Platform* platform);
+  ~IsolateGCDelegate() override;
+
+  // GCScheduler::Delegate:
+  size_t GetUsedHeapSize() override;
+  bool NotifyIdle(base::TimeDelta idle_time) override;
+  void NotifyLowMemory() override;
+
+ private:
+  v8::Isolate* isolate_;
+  v8::Platform* platform_;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolateGCDelegate);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_GC_SCHEDULER_H_
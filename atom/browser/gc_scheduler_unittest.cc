@@ -0,0 +1,146 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/gc_scheduler.h"
+
+#include <memory>
+
+#include "base/bind.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/timer/timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace atom {
+
+namespace {
+
+const size_t kMB = 1024 * 1024;
+
+class FakeGCDelegate : public GCScheduler::Delegate {
+ public:
+  FakeGCDelegate() = default;
+
+  void Allocate(size_t size) { heap_size_ += size; }
+
+  int idle_notifications() const { return idle_notifications_; }
+  int low_memory_notifications() const { return low_memory_notifications_; }
+
+  // GCScheduler::Delegate:
+  size_t GetUsedHeapSize() override { return heap_size_; }
+
+  bool NotifyIdle(base::TimeDelta idle_time) override {
+    ++idle_notifications_;
+    heap_size_ = kLiveSize;
+    return true;
+  }
+
+  void NotifyLowMemory() override {
+    ++low_memory_notifications_;
+    heap_size_ = kLiveSize;
+  }
+
+ private:
+  static const size_t kLiveSize = 10 * kMB;
+
+  size_t heap_size_ = kLiveSize;
+  int idle_notifications_ = 0;
+  int low_memory_notifications_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeGCDelegate);
+};
+
+class GCSchedulerTest : public testing::Test {
+ protected:
+  GCSchedulerTest()
+      : task_environment_(
+            base::test::ScopedTaskEnvironment::MainThreadType::MOCK_TIME) {}
+
+  void SetUp() override {
+    auto delegate = std::make_unique<FakeGCDelegate>();
+    delegate_ = delegate.get();
+    scheduler_ = std::make_unique<GCScheduler>(
+        std::move(delegate), GCScheduler::Options(),
+        task_environment_.GetMockTickClock());
+    scheduler_->Start();
+  }
+
+  void TearDown() override { scheduler_.reset(); }
+
+  // Keeps the message loop busy with a task every |interval| which allocates
+  // |size| bytes.
+  void StartAllocating(base::TimeDelta interval, size_t size) {
+    allocation_timer_.Start(FROM_HERE, interval,
+                            base::BindRepeating(&FakeGCDelegate::Allocate,
+                                                base::Unretained(delegate_),
+                                                size));
+  }
+
+  void SimulateMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level) {
+    base::MemoryPressureListener::SimulatePressureNotification(level);
+    task_environment_.RunUntilIdle();
+  }
+
+  base::test::ScopedTaskEnvironment task_environment_;
+  FakeGCDelegate* delegate_ = nullptr;
+  std::unique_ptr<GCScheduler> scheduler_;
+  base::RepeatingTimer allocation_timer_;
+};
+
+}  // namespace
+
+TEST_F(GCSchedulerTest, NoFullCollectionsWithoutMemoryPressure) {
+  // A periodic timer would have forced 10 full collections by now.
+  StartAllocating(base::TimeDelta::FromSeconds(10), 4 * kMB);
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(10));
+
+  EXPECT_EQ(0, delegate_->low_memory_notifications());
+  EXPECT_GT(delegate_->idle_notifications(), 0);
+}
+
+TEST_F(GCSchedulerTest, SkipsCollectionsWhenHeapDidNotGrow) {
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(10));
+
+  EXPECT_EQ(0, delegate_->idle_notifications());
+  EXPECT_EQ(0, delegate_->low_memory_notifications());
+}
+
+TEST_F(GCSchedulerTest, DefersCollectionsWhileBusy) {
+  StartAllocating(base::TimeDelta::FromMilliseconds(100), kMB);
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(1));
+  EXPECT_EQ(0, delegate_->idle_notifications());
+
+  allocation_timer_.Stop();
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(2));
+  EXPECT_EQ(1, delegate_->idle_notifications());
+  EXPECT_EQ(0, delegate_->low_memory_notifications());
+}
+
+TEST_F(GCSchedulerTest, EscalatesUnderMemoryPressure) {
+  // Moderate pressure is ignored until the heap grew enough.
+  SimulateMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(0, delegate_->low_memory_notifications());
+
+  delegate_->Allocate(16 * kMB);
+  SimulateMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(1, delegate_->low_memory_notifications());
+
+  delegate_->Allocate(kMB);
+  SimulateMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(1, delegate_->low_memory_notifications());
+
+  // Critical pressure collects any garbage.
+  SimulateMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_EQ(2, delegate_->low_memory_notifications());
+
+  SimulateMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_EQ(2, delegate_->low_memory_notifications());
+}
+
+}  // namespace atom
@@ -17,6 +17,7 @@
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -91,6 +92,8 @@ void URLRequestAsarJob::InitializeFileJob(
 }
 
 void URLRequestAsarJob::Start() {
+  TRACE_EVENT1("electron.asar", "URLRequestAsarJob::Start", "url",
+               request()->url().possibly_invalid_spec());
   if (type_ == TYPE_ASAR || type_ == TYPE_FILE) {
     auto* meta_info = new FileMetaInfo();
     if (type_ == TYPE_ASAR) {
@@ -12,6 +12,7 @@
 #include "base/containers/linked_list.h"
 #include "base/memory/weak_ptr.h"
 #include "base/task/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
@@ -28,6 +29,9 @@ VerifyRequestParams::VerifyRequestParams(const VerifyRequestParams&) = default;
 
 namespace {
 
+// The maximum number of verify proc results kept by the verdict cache.
+const size_t kMaxCachedVerdicts = 256;
+
 class Response : public base::LinkNode<Response> {
  public:
   Response(net::CertVerifyResult* verify_result,
@@ -51,6 +55,7 @@ class CertVerifierRequest : public AtomCertVerifier::Request {
                       AtomCertVerifier* cert_verifier)
       : params_(params),
         cert_verifier_(cert_verifier),
+        cache_generation_(cert_verifier->cache_generation()),
         weak_ptr_factory_(this) {}
 
   ~CertVerifierRequest() override {
@@ -91,35 +96,59 @@ class CertVerifierRequest : public AtomCertVerifier::Request {
 
   void OnDefaultVerificationDone(int error) {
     error_ = error;
+    verdict_key_ = std::make_tuple(
+        params_.hostname(),
+        net::X509Certificate::CalculateFingerprint256(
+            params_.certificate()->cert_buffer()),
+        params_.certificate()->CalculateChainFingerprint256(), error);
+
+    int cached_result;
+    if (cert_verifier_->GetCachedVerdict(verdict_key_, &cached_result)) {
+      // The default verification may complete synchronously before any
+      // response listener has been added, so always respond asynchronously.
+      base::ThreadTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&CertVerifierRequest::NotifyResponseInIO,
+                                    weak_ptr_factory_.GetWeakPtr(),
+                                    cached_result, 0));
+      return;
+    }
+
     auto request = std::make_unique<VerifyRequestParams>();
     request->hostname = params_.hostname();
     request->default_result = net::ErrorToString(error);
     request->error_code = error;
     request->certificate = params_.certificate();
-    auto response_callback = base::Bind(&CertVerifierRequest::OnResponseInUI,
-                                        weak_ptr_factory_.GetWeakPtr());
+    auto response_callback =
+        base::BindOnce(&CertVerifierRequest::OnResponseInUI,
+                       weak_ptr_factory_.GetWeakPtr());
     base::PostTaskWithTraits(
         FROM_HERE, {BrowserThread::UI},
         base::BindOnce(&CertVerifierRequest::OnVerifyRequestInUI,
                        cert_verifier_->verify_proc(), std::move(request),
-                       response_callback));
+                       std::move(response_callback)));
   }
 
   static void OnVerifyRequestInUI(
       const AtomCertVerifier::VerifyProc& verify_proc,
       std::unique_ptr<VerifyRequestParams> request,
-      const base::Callback<void(int)>& response_callback) {
-    verify_proc.Run(*(request.get()), response_callback);
+      AtomCertVerifier::VerifyResultCallback response_callback) {
+    verify_proc.Run(*(request.get()), std::move(response_callback));
   }
 
   static void OnResponseInUI(base::WeakPtr<CertVerifierRequest> self,
-                             int result) {
+                             int result,
+                             int cache_max_age) {
     base::PostTaskWithTraits(
         FROM_HERE, {BrowserThread::IO},
-        base::BindOnce(&CertVerifierRequest::NotifyResponseInIO, self, result));
+        base::BindOnce(&CertVerifierRequest::NotifyResponseInIO, self, result,
+                       cache_max_age));
   }
 
-  void NotifyResponseInIO(int result) {
+  void NotifyResponseInIO(int result, int cache_max_age) {
+    if (cache_max_age > 0)
+      cert_verifier_->CacheVerdict(verdict_key_, cache_generation_, result,
+                                   cache_max_age);
+
     custom_response_ = result;
     first_response_ = false;
     // Responding to first request in the list will initiate destruction of
@@ -142,23 +171,36 @@ class CertVerifierRequest : public AtomCertVerifier::Request {
 
   const AtomCertVerifier::RequestParams params_;
   AtomCertVerifier* cert_verifier_;
+  // The generation of the verdict cache when the request started.
+  const uint64_t cache_generation_;
   int error_ = net::ERR_IO_PENDING;
   int custom_response_ = net::ERR_IO_PENDING;
   bool first_response_ = true;
   ResponseList response_list_;
+  AtomCertVerifier::VerdictKey verdict_key_;
   net::CertVerifyResult result_;
   std::unique_ptr<AtomCertVerifier::Request> default_verifier_request_;
   base::WeakPtrFactory<CertVerifierRequest> weak_ptr_factory_;
 };
 
 AtomCertVerifier::AtomCertVerifier(RequireCTDelegate* ct_delegate)
-    : default_cert_verifier_(net::CertVerifier::CreateDefault()),
+    : verdict_cache_(kMaxCachedVerdicts),
+      default_cert_verifier_(net::CertVerifier::CreateDefault()),
       ct_delegate_(ct_delegate) {}
 
 AtomCertVerifier::~AtomCertVerifier() {}
 
 void AtomCertVerifier::SetVerifyProc(const VerifyProc& proc) {
   verify_proc_ = proc;
+  // Results of the previous proc do not apply to the new one.
+  ClearVerifyCache();
+}
+
+void AtomCertVerifier::ClearVerifyCache() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  verdict_cache_.Clear();
+  // Verdicts of requests still in flight belong to the cleared cache.
+  ++cache_generation_;
 }
 
 int AtomCertVerifier::Verify(const RequestParams& params,
@@ -198,6 +240,29 @@ void AtomCertVerifier::RemoveRequest(const RequestParams& params) {
     inflight_requests_.erase(it);
 }
 
+bool AtomCertVerifier::GetCachedVerdict(const VerdictKey& key, int* result) {
+  auto it = verdict_cache_.Get(key);
+  if (it == verdict_cache_.end())
+    return false;
+  if (it->second.expiry <= base::TimeTicks::Now()) {
+    verdict_cache_.Erase(it);
+    return false;
+  }
+  *result = it->second.result;
+  return true;
+}
+
+void AtomCertVerifier::CacheVerdict(const VerdictKey& key,
+                                    uint64_t generation,
+                                    int result,
+                                    int max_age) {
+  if (generation != cache_generation_)
+    return;
+  base::TimeTicks expiry =
+      base::TimeTicks::Now() + base::TimeDelta::FromSeconds(max_age);
+  verdict_cache_.Put(key, {result, expiry});
+}
+
 CertVerifierRequest* AtomCertVerifier::FindRequest(
     const RequestParams& params) {
   auto it = inflight_requests_.find(params);
@@ -8,7 +8,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 
+#include "base/containers/mru_cache.h"
+#include "base/time/time.h"
+#include "net/base/hash_value.h"
 #include "net/cert/cert_verifier.h"
 
 namespace atom {
@@ -32,12 +36,20 @@ class AtomCertVerifier : public net::CertVerifier {
   explicit AtomCertVerifier(RequireCTDelegate* ct_delegate);
   ~AtomCertVerifier() override;
 
+  // Called with the verification result and the number of seconds the result
+  // can be reused for identical verifications, 0 means it is not cached.
+  using VerifyResultCallback =
+      base::OnceCallback<void(int result, int cache_max_age)>;
   using VerifyProc = base::Callback<void(const VerifyRequestParams& request,
-                                         net::CompletionOnceCallback)>;
+                                         VerifyResultCallback)>;
 
   void SetVerifyProc(const VerifyProc& proc);
 
+  // Forgets the results cached from the verify proc.
+  void ClearVerifyCache();
+
   const VerifyProc verify_proc() const { return verify_proc_; }
+  uint64_t cache_generation() const { return cache_generation_; }
   RequireCTDelegate* ct_delegate() const { return ct_delegate_; }
   net::CertVerifier* default_verifier() const {
     return default_cert_verifier_.get();
@@ -55,10 +67,29 @@ class AtomCertVerifier : public net::CertVerifier {
  private:
   friend class CertVerifierRequest;
 
+  // (hostname, leaf fingerprint, chain fingerprint, default result).
+  using VerdictKey =
+      std::tuple<std::string, net::SHA256HashValue, net::SHA256HashValue, int>;
+
+  struct Verdict {
+    int result;
+    base::TimeTicks expiry;
+  };
+
   void RemoveRequest(const RequestParams& params);
   CertVerifierRequest* FindRequest(const RequestParams& params);
 
+  bool GetCachedVerdict(const VerdictKey& key, int* result);
+  // Drops the verdict if the cache was cleared since |generation|.
+  void CacheVerdict(const VerdictKey& key,
+                    uint64_t generation,
+                    int result,
+                    int max_age);
+
   std::map<RequestParams, CertVerifierRequest*> inflight_requests_;
+  base::MRUCache<VerdictKey, Verdict> verdict_cache_;
+  // Incremented whenever the verdict cache is cleared or the proc replaced.
+  uint64_t cache_generation_ = 0;
   VerifyProc verify_proc_;
   std::unique_ptr<net::CertVerifier> default_cert_verifier_;
   RequireCTDelegate* ct_delegate_;
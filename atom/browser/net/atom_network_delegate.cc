@@ -15,6 +15,7 @@
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
@@ -48,6 +49,17 @@ const char* ResourceTypeToString(content::ResourceType type) {
   }
 }
 
+bool MatchesFilterCondition(const GURL& url, const URLPatterns& patterns) {
+  if (patterns.empty())
+    return true;
+
+  for (const auto& pattern : patterns) {
+    if (pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
 int32_t GetWebContentsID(int process_id, int frame_id) {
   auto* webContents = content::WebContents::FromRenderFrameHost(
       content::RenderFrameHost::FromID(process_id, frame_id));
@@ -63,6 +75,7 @@ void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
                        std::unique_ptr<base::DictionaryValue> details,
                        int render_process_id,
                        int render_frame_id) {
+  TRACE_EVENT0("electron.net", "AtomNetworkDelegate::RunSimpleListener");
   int32_t id = GetWebContentsID(render_process_id, render_frame_id);
   // id must be greater than zero
   if (id)
@@ -76,6 +89,7 @@ void RunResponseListener(
     int render_process_id,
     int render_frame_id,
     const AtomNetworkDelegate::ResponseCallback& callback) {
+  TRACE_EVENT0("electron.net", "AtomNetworkDelegate::RunResponseListener");
   int32_t id = GetWebContentsID(render_process_id, render_frame_id);
   // id must be greater than zero
   if (id)
@@ -83,19 +97,6 @@ void RunResponseListener(
   return listener.Run(*(details.get()), callback);
 }
 
-// Test whether the URL of |request| matches |patterns|.
-bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
-  }
-  return false;
-}
-
 // Overloaded by multiple types to fill the |details| object.
 void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
   FillRequestDetails(details, request);
@@ -471,7 +472,7 @@ int AtomNetworkDelegate::HandleResponseEvent(
     Out out,
     Args... args) {
   const auto& info = response_listeners_[type];
-  if (!MatchesFilterCondition(request, info.url_patterns))
+  if (!MatchesFilterCondition(request->url(), info.url_patterns))
     return net::OK;
 
   auto details = std::make_unique<base::DictionaryValue>();
@@ -484,6 +485,12 @@ int AtomNetworkDelegate::HandleResponseEvent(
   // The |request| could be destroyed before the |callback| is called.
   callbacks_[request->identifier()] = std::move(callback);
 
+  // Spans the hop to the listener on the UI thread and back.
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN1(
+      "electron.net", "AtomNetworkDelegate::ResponseListener",
+      TRACE_ID_LOCAL(request->identifier()), "url",
+      request->url().possibly_invalid_spec());
+
   ResponseCallback response =
       base::Bind(&AtomNetworkDelegate::OnListenerResultInUI<Out>,
                  base::Unretained(this), request->identifier(), out);
@@ -499,7 +506,7 @@ void AtomNetworkDelegate::HandleSimpleEvent(SimpleEvent type,
                                             net::URLRequest* request,
                                             Args... args) {
   const auto& info = simple_listeners_[type];
-  if (!MatchesFilterCondition(request, info.url_patterns))
+  if (!MatchesFilterCondition(request->url(), info.url_patterns))
     return;
 
   auto details = std::make_unique<base::DictionaryValue>();
@@ -520,6 +527,9 @@ void AtomNetworkDelegate::OnListenerResultInIO(
     uint64_t id,
     T out,
     std::unique_ptr<base::DictionaryValue> response) {
+  TRACE_EVENT_NESTABLE_ASYNC_END0("electron.net",
+                                  "AtomNetworkDelegate::ResponseListener",
+                                  TRACE_ID_LOCAL(id));
   // The request has been destroyed.
   if (!base::ContainsKey(callbacks_, id))
     return;
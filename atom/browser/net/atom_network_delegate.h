@@ -19,6 +19,7 @@
 #include "net/base/network_delegate.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
+#include "url/gurl.h"
 
 class URLPattern;
 
@@ -28,6 +29,9 @@ using URLPatterns = std::set<URLPattern>;
 
 const char* ResourceTypeToString(content::ResourceType type);
 
+// Test whether |url| matches |patterns|, an empty set matches every URL.
+bool MatchesFilterCondition(const GURL& url, const URLPatterns& patterns);
+
 class LoginHandler;
 
 class AtomNetworkDelegate : public net::NetworkDelegate {
@@ -0,0 +1,66 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/atom_network_delegate.h"
+
+#include <string>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "extensions/common/url_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+const int kLookups = 10000;
+
+URLPatterns CreatePatterns(int count) {
+  URLPatterns patterns;
+  for (int i = 0; i < count; ++i) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    EXPECT_EQ(URLPattern::ParseResult::kSuccess,
+              pattern.Parse(base::StringPrintf(
+                  "https://host%d.example.com/path%d/*", i, i)));
+    patterns.insert(pattern);
+  }
+  return patterns;
+}
+
+void RunMatches(const URLPatterns& patterns,
+                const GURL& url,
+                bool expected,
+                const std::string& trace) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kLookups; ++i)
+    ASSERT_EQ(expected, MatchesFilterCondition(url, patterns));
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult("matches_filter_condition", "", trace,
+                         elapsed.InMicrosecondsF() / kLookups, "us", true);
+}
+
+}  // namespace
+
+TEST(AtomNetworkDelegatePerfTest, MatchesFilterConditionMiss) {
+  URLPatterns patterns = CreatePatterns(1000);
+  RunMatches(patterns, GURL("https://unmatched.example.com/index.html"), false,
+             "1k_patterns_miss");
+}
+
+TEST(AtomNetworkDelegatePerfTest, MatchesFilterConditionHit) {
+  URLPatterns patterns = CreatePatterns(1000);
+  RunMatches(patterns, GURL("https://host500.example.com/path500/index.html"),
+             true, "1k_patterns_hit");
+}
+
+TEST(AtomNetworkDelegatePerfTest, MatchesFilterConditionEmpty) {
+  RunMatches(URLPatterns(), GURL("https://example.com/index.html"), true,
+             "no_patterns");
+}
+
+}  // namespace atom
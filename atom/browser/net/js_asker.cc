@@ -4,13 +4,33 @@
 
 #include "atom/browser/net/js_asker.h"
 
+#include <string>
 #include <utility>
 
 #include "atom/common/native_mate_converters/callback.h"
+#include "base/atomic_sequence_num.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/browser_thread.h"
 
 namespace atom {
 
+namespace {
+
+// Ids of the async trace events spanning a call into a protocol handler.
+base::AtomicSequenceNumber g_next_ask_id;
+
+// Closes the async trace event of the ask before handing the options back to
+// the job.
+void BeforeStartTraced(int ask_id,
+                       const BeforeStartCallback& before_start,
+                       mate::Arguments* args) {
+  TRACE_EVENT_NESTABLE_ASYNC_END0("electron.net", "JsAsker::Handler",
+                                  TRACE_ID_LOCAL(ask_id));
+  before_start.Run(args);
+}
+
+}  // namespace
+
 JsAsker::JsAsker() = default;
 
 JsAsker::~JsAsker() = default;
@@ -35,8 +55,18 @@ void JsAsker::AskForOptions(
   v8::HandleScope handle_scope(isolate);
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
   v8::Context::Scope context_scope(context);
+
+  int ask_id = g_next_ask_id.GetNext();
+  // The url is only copied into the trace when the category is enabled.
+  const base::Value* url =
+      request_details->FindKeyOfType("url", base::Value::Type::STRING);
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN1("electron.net", "JsAsker::Handler",
+                                    TRACE_ID_LOCAL(ask_id), "url",
+                                    url ? url->GetString() : std::string());
+  TRACE_EVENT0("electron.net", "JsAsker::AskForOptions");
   handler.Run(*(request_details.get()),
-              mate::ConvertToV8(isolate, before_start));
+              mate::ConvertToV8(isolate, base::Bind(&BeforeStartTraced, ask_id,
+                                                    before_start)));
 }
 
 // static
@@ -4,13 +4,17 @@
 
 #include "atom/browser/net/resolve_proxy_helper.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "atom/browser/atom_browser_context.h"
 #include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/network_service_instance.h"
 #include "content/public/browser/storage_partition.h"
 #include "mojo/public/cpp/bindings/interface_request.h"
+#include "net/base/net_errors.h"
 #include "net/proxy_resolution/proxy_info.h"
 #include "services/network/public/mojom/network_context.mojom.h"
 
@@ -18,13 +22,31 @@ using content::BrowserThread;
 
 namespace atom {
 
+namespace {
+
+// Default number of lookups that can be in progress at the same time.
+const size_t kDefaultMaxConcurrentLookups = 8;
+
+// Maximum number of results kept in the cache, and how long they are kept.
+const size_t kMaxCachedResults = 64;
+const int kCachedResultTTLSeconds = 10;
+
+}  // namespace
+
 ResolveProxyHelper::ResolveProxyHelper(AtomBrowserContext* browser_context)
-    : binding_(this), browser_context_(browser_context) {}
+    : max_concurrent_lookups_(kDefaultMaxConcurrentLookups),
+      cache_(kMaxCachedResults),
+      browser_context_(browser_context) {
+  bindings_.set_connection_error_handler(
+      base::BindRepeating(&ResolveProxyHelper::OnProxyLookupComplete,
+                          base::Unretained(this), net::ERR_ABORTED,
+                          base::nullopt));
+  content::GetNetworkConnectionTracker()->AddNetworkConnectionObserver(this);
+}
 
 ResolveProxyHelper::~ResolveProxyHelper() {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  DCHECK(!owned_self_);
-  DCHECK(!binding_.is_bound());
+  content::GetNetworkConnectionTracker()->RemoveNetworkConnectionObserver(this);
   // Clear all pending requests if the ProxyService is still alive.
   pending_requests_.clear();
 }
@@ -32,69 +54,100 @@ ResolveProxyHelper::~ResolveProxyHelper() {
 void ResolveProxyHelper::ResolveProxy(const GURL& url,
                                       const ResolveProxyCallback& callback) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  // Enqueue the pending request.
-  pending_requests_.push_back(PendingRequest(url, callback));
-
-  // If nothing is in progress, start.
-  if (!binding_.is_bound()) {
-    DCHECK_EQ(1u, pending_requests_.size());
-    StartPendingRequest();
+  auto cached = cache_.Get(url);
+  if (cached != cache_.end()) {
+    if (cached->second.expiry > base::TimeTicks::Now()) {
+      if (!callback.is_null()) {
+        base::ThreadTaskRunnerHandle::Get()->PostTask(
+            FROM_HERE, base::BindOnce(callback, cached->second.proxy));
+      }
+      return;
+    }
+    cache_.Erase(cached);
   }
+
+  // Join the lookup of the same URL if there is one.
+  LookupKey key(url, cache_generation_);
+  auto& callbacks = pending_requests_[key];
+  callbacks.push_back(callback);
+  if (callbacks.size() > 1)
+    return;
+
+  queued_lookups_.push_back(std::move(key));
+  StartPendingLookups();
+}
+
+void ResolveProxyHelper::SetMaxConcurrentLookups(
+    size_t max_concurrent_lookups) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  max_concurrent_lookups_ = std::max<size_t>(max_concurrent_lookups, 1);
+  StartPendingLookups();
 }
 
-void ResolveProxyHelper::StartPendingRequest() {
+void ResolveProxyHelper::ClearCache() {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  DCHECK(!binding_.is_bound());
-  DCHECK(!pending_requests_.empty());
-
-  // Start the request.
-  network::mojom::ProxyLookupClientPtr proxy_lookup_client;
-  binding_.Bind(mojo::MakeRequest(&proxy_lookup_client));
-  binding_.set_connection_error_handler(
-      base::BindOnce(&ResolveProxyHelper::OnProxyLookupComplete,
-                     base::Unretained(this), net::ERR_ABORTED, base::nullopt));
-  content::BrowserContext::GetDefaultStoragePartition(browser_context_)
-      ->GetNetworkContext()
-      ->LookUpProxyForURL(pending_requests_.front().url,
-                          std::move(proxy_lookup_client));
+  cache_.Clear();
+  ++cache_generation_;
+}
+
+void ResolveProxyHelper::StartPendingLookups() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto* network_context =
+      content::BrowserContext::GetDefaultStoragePartition(browser_context_)
+          ->GetNetworkContext();
+  while (!queued_lookups_.empty() &&
+         bindings_.size() < max_concurrent_lookups_) {
+    LookupKey key = std::move(queued_lookups_.front());
+    queued_lookups_.pop_front();
+
+    GURL url = key.first;
+    network::mojom::ProxyLookupClientPtr proxy_lookup_client;
+    bindings_.AddBinding(this, mojo::MakeRequest(&proxy_lookup_client),
+                         std::move(key));
+    network_context->LookUpProxyForURL(url, std::move(proxy_lookup_client));
+  }
 }
 
 void ResolveProxyHelper::OnProxyLookupComplete(
     int32_t net_error,
     const base::Optional<net::ProxyInfo>& proxy_info) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  DCHECK(!pending_requests_.empty());
-
-  binding_.Close();
-
-  // Clear the current (completed) request.
-  PendingRequest completed_request = std::move(pending_requests_.front());
-  pending_requests_.pop_front();
+  // Copy the context, it is destroyed with the binding.
+  const LookupKey context = bindings_.dispatch_context();
+  bindings_.RemoveBinding(bindings_.dispatch_binding());
 
   std::string proxy;
   if (proxy_info)
     proxy = proxy_info->ToPacString();
 
-  if (!completed_request.callback.is_null())
-    completed_request.callback.Run(proxy);
+  if (proxy_info && context.second == cache_generation_) {
+    base::TimeTicks expiry =
+        base::TimeTicks::Now() +
+        base::TimeDelta::FromSeconds(kCachedResultTTLSeconds);
+    cache_.Put(context.first, {proxy, expiry});
+  }
 
-  // Start the next request.
-  if (!pending_requests_.empty())
-    StartPendingRequest();
+  CompleteLookup(context, proxy);
+  StartPendingLookups();
 }
 
-ResolveProxyHelper::PendingRequest::PendingRequest(
-    const GURL& url,
-    const ResolveProxyCallback& callback)
-    : url(url), callback(callback) {}
-
-ResolveProxyHelper::PendingRequest::PendingRequest(
-    ResolveProxyHelper::PendingRequest&& pending_request) = default;
-
-ResolveProxyHelper::PendingRequest::~PendingRequest() noexcept = default;
+void ResolveProxyHelper::OnConnectionChanged(
+    network::mojom::ConnectionType type) {
+  ClearCache();
+}
 
-ResolveProxyHelper::PendingRequest& ResolveProxyHelper::PendingRequest::
-operator=(ResolveProxyHelper::PendingRequest&& pending_request) noexcept =
-    default;
+void ResolveProxyHelper::CompleteLookup(const LookupKey& key,
+                                        const std::string& proxy) {
+  auto it = pending_requests_.find(key);
+  if (it == pending_requests_.end())
+    return;
+
+  std::vector<ResolveProxyCallback> callbacks = std::move(it->second);
+  pending_requests_.erase(it);
+  for (const auto& callback : callbacks) {
+    if (!callback.is_null())
+      callback.Run(proxy);
+  }
+}
 
 }  // namespace atom
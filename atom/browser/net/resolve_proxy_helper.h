@@ -6,11 +6,17 @@
 #define ATOM_BROWSER_NET_RESOLVE_PROXY_HELPER_H_
 
 #include <deque>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/optional.h"
-#include "mojo/public/cpp/bindings/binding.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/bindings/binding_set.h"
+#include "services/network/public/cpp/network_connection_tracker.h"
 #include "services/network/public/mojom/proxy_lookup_client.mojom.h"
 #include "url/gurl.h"
 
@@ -20,7 +26,8 @@ class AtomBrowserContext;
 
 class ResolveProxyHelper
     : public base::RefCountedThreadSafe<ResolveProxyHelper>,
-      network::mojom::ProxyLookupClient {
+      network::mojom::ProxyLookupClient,
+      network::NetworkConnectionTracker::NetworkConnectionObserver {
  public:
   using ResolveProxyCallback = base::Callback<void(std::string)>;
 
@@ -28,41 +35,54 @@ class ResolveProxyHelper
 
   void ResolveProxy(const GURL& url, const ResolveProxyCallback& callback);
 
+  // Sets how many lookups can be in progress at the same time.
+  void SetMaxConcurrentLookups(size_t max_concurrent_lookups);
+
+  // Forgets the cached results, must be called when the proxy settings change.
+  void ClearCache();
+
  protected:
   ~ResolveProxyHelper() override;
 
  private:
   friend class base::RefCountedThreadSafe<ResolveProxyHelper>;
-  // A PendingRequest is a resolve request that is in progress, or queued.
-  struct PendingRequest {
-   public:
-    PendingRequest(const GURL& url, const ResolveProxyCallback& callback);
-    PendingRequest(PendingRequest&& pending_request) noexcept;
-    ~PendingRequest();
-
-    PendingRequest& operator=(PendingRequest&& pending_request) noexcept;
-
-    GURL url;
-    ResolveProxyCallback callback;
 
-   private:
-    DISALLOW_COPY_AND_ASSIGN(PendingRequest);
+  struct CachedResult {
+    std::string proxy;
+    base::TimeTicks expiry;
   };
 
-  // Starts the first pending request.
-  void StartPendingRequest();
+  // A URL and the generation of the cache its lookup was requested in.
+  using LookupKey = std::pair<GURL, int>;
+
+  // Starts queued lookups until the concurrency limit is reached.
+  void StartPendingLookups();
 
   // network::mojom::ProxyLookupClient implementation.
   void OnProxyLookupComplete(
       int32_t net_error,
       const base::Optional<net::ProxyInfo>& proxy_info) override;
 
-  // Self-reference. Owned as long as there's an outstanding proxy lookup.
-  scoped_refptr<ResolveProxyHelper> owned_self_;
+  // network::NetworkConnectionTracker::NetworkConnectionObserver:
+  void OnConnectionChanged(network::mojom::ConnectionType type) override;
+
+  void CompleteLookup(const LookupKey& key, const std::string& proxy);
+
+  // Callbacks waiting for each URL, a URL is only looked up once no matter how
+  // many requests are waiting for it. Requests made after the cache was
+  // cleared do not join the lookups started with the previous settings.
+  std::map<LookupKey, std::vector<ResolveProxyCallback>> pending_requests_;
+  // Lookups waiting for a free slot.
+  std::deque<LookupKey> queued_lookups_;
+
+  // Bindings of the in-progress lookups.
+  mojo::BindingSet<network::mojom::ProxyLookupClient, LookupKey> bindings_;
+  size_t max_concurrent_lookups_;
 
-  std::deque<PendingRequest> pending_requests_;
-  // Binding for the currently in-progress request, if any.
-  mojo::Binding<network::mojom::ProxyLookupClient> binding_;
+  base::MRUCache<GURL, CachedResult> cache_;
+  // Bumped whenever the cache is cleared, so lookups started before that do
+  // not populate the cache with stale results.
+  int cache_generation_ = 0;
 
   // Weak Ref
   AtomBrowserContext* browser_context_;
@@ -0,0 +1,56 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/osr/osr_frame_pool.h"
+
+#include <utility>
+
+#include "third_party/skia/include/core/SkPixelRef.h"
+
+namespace atom {
+
+namespace {
+
+// Enough to cover a frame being painted while the consumer still holds on to
+// the previous ones.
+const size_t kMaxFreeFrames = 3;
+
+}  // namespace
+
+OffScreenFramePool::OffScreenFramePool() = default;
+
+OffScreenFramePool::~OffScreenFramePool() = default;
+
+SkBitmap OffScreenFramePool::Acquire(const gfx::Size& size_in_pixels) {
+  for (auto it = free_frames_.begin(); it != free_frames_.end(); ++it) {
+    // A frame can be given back while the paint that produced it is still on
+    // the stack, so it only becomes reusable once the pool is the last owner.
+    if (it->width() == size_in_pixels.width() &&
+        it->height() == size_in_pixels.height() && it->pixelRef()->unique()) {
+      SkBitmap bitmap = std::move(*it);
+      free_frames_.erase(it);
+      return bitmap;
+    }
+  }
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(size_in_pixels.width(), size_in_pixels.height(),
+                        false);
+  return bitmap;
+}
+
+void OffScreenFramePool::Recycle(SkBitmap bitmap) {
+  if (!bitmap.pixelRef())
+    return;
+
+  // Frames of the old size are useless after a resize.
+  if (!free_frames_.empty() &&
+      free_frames_.front().dimensions() != bitmap.dimensions())
+    free_frames_.clear();
+
+  if (free_frames_.size() < kMaxFreeFrames)
+    free_frames_.push_back(std::move(bitmap));
+}
+
+}  // namespace atom
@@ -0,0 +1,42 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_OSR_OSR_FRAME_POOL_H_
+#define ATOM_BROWSER_OSR_OSR_FRAME_POOL_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace atom {
+
+// Recycles the bitmaps handed to the paint callback of offscreen views, so
+// painting does not allocate a new frame for every paint when the consumer
+// gives the frames back.
+class OffScreenFramePool : public base::RefCounted<OffScreenFramePool> {
+ public:
+  OffScreenFramePool();
+
+  // Returns a frame of |size_in_pixels|, reusing a recycled one if possible.
+  SkBitmap Acquire(const gfx::Size& size_in_pixels);
+
+  // Gives |bitmap| back to the pool, the caller must not write to its pixels
+  // afterwards.
+  void Recycle(SkBitmap bitmap);
+
+ private:
+  friend class base::RefCounted<OffScreenFramePool>;
+  ~OffScreenFramePool();
+
+  std::vector<SkBitmap> free_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(OffScreenFramePool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_OSR_OSR_FRAME_POOL_H_
@@ -312,6 +312,7 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
       parent_host_view_(parent_host_view),
       transparent_(transparent),
       callback_(callback),
+      frame_pool_(new OffScreenFramePool),
       frame_rate_(frame_rate),
       size_(initial_size),
       painting_(painting),
@@ -947,9 +948,7 @@ void OffScreenRenderWidgetHostView::OnPaint(const gfx::Rect& damage_rect,
     gfx::Size size_in_pixels = gfx::ConvertSizeToPixel(
         current_device_scale_factor_, GetViewBounds().size());
 
-    SkBitmap backing;
-    backing.allocN32Pixels(size_in_pixels.width(), size_in_pixels.height(),
-                           false);
+    SkBitmap backing = frame_pool_->Acquire(size_in_pixels);
     SkCanvas canvas(backing);
 
     canvas.writePixels(bitmap, 0, 0);
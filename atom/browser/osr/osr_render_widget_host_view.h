@@ -14,6 +14,7 @@
 #include <windows.h>
 #endif
 
+#include "atom/browser/osr/osr_frame_pool.h"
 #include "atom/browser/osr/osr_output_device.h"
 #include "atom/browser/osr/osr_view_proxy.h"
 #include "base/process/kill.h"
@@ -247,6 +248,9 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
 
   gfx::Size size() const { return size_; }
 
+  // The pool the frames passed to the paint callback are taken from.
+  OffScreenFramePool* frame_pool() const { return frame_pool_.get(); }
+
   void set_popup_host_view(OffScreenRenderWidgetHostView* popup_view) {
     popup_host_view_ = popup_view;
   }
@@ -286,6 +290,7 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   const bool transparent_;
   OnPaintCallback callback_;
   OnPaintCallback parent_callback_;
+  scoped_refptr<OffScreenFramePool> frame_pool_;
 
   int frame_rate_ = 0;
   int frame_rate_threshold_us_ = 0;
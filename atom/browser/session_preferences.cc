@@ -7,6 +7,7 @@
 #include "atom/common/options_switches.h"
 #include "base/command_line.h"
 #include "base/memory/ptr_util.h"
+#include "base/strings/string_util.h"
 
 namespace atom {
 
@@ -56,6 +57,18 @@ void SessionPreferences::AppendExtraCommandLineSwitches(
   }
   if (!preloads.empty())
     command_line->AppendSwitchNative(switches::kPreloadScripts, preloads);
+
+  // The code cache lives next to the one of Chromium, sessions that are not
+  // persisted have nowhere to keep it.
+  if (!self->code_cache_schemes().empty() && !context->IsOffTheRecord()) {
+    command_line->AppendSwitchASCII(
+        switches::kCodeCacheSchemes,
+        base::JoinString(self->code_cache_schemes(), ","));
+    command_line->AppendSwitchPath(switches::kCodeCachePath,
+                                   context->GetPath()
+                                       .Append(FILE_PATH_LITERAL("Code Cache"))
+                                       .Append(FILE_PATH_LITERAL("node")));
+  }
 }
 
 }  // namespace atom
@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_SESSION_PREFERENCES_H_
 #define ATOM_BROWSER_SESSION_PREFERENCES_H_
 
+#include <string>
 #include <vector>
 
 #include "base/files/file_path.h"
@@ -34,11 +35,19 @@ class SessionPreferences : public base::SupportsUserData::Data {
     return preloads_;
   }
 
+  void set_code_cache_schemes(const std::vector<std::string>& schemes) {
+    code_cache_schemes_ = schemes;
+  }
+  const std::vector<std::string>& code_cache_schemes() const {
+    return code_cache_schemes_;
+  }
+
  private:
   // The user data key.
   static int kLocatorKey;
 
   std::vector<base::FilePath::StringType> preloads_;
+  std::vector<std::string> code_cache_schemes_;
 };
 
 }  // namespace atom
@@ -0,0 +1,205 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/spare_renderer_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "atom/browser/session_preferences.h"
+#include "atom/browser/web_contents_preferences.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/task/post_task.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/child_process_termination_info.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace {
+
+// Spares that may exit unexpectedly in a row before the pool stops relaunching
+// them, so a renderer that crashes on start is not relaunched forever.
+const int kMaxRelaunches = 3;
+
+}  // namespace
+
+SpareRendererPool::Spare::Spare() = default;
+SpareRendererPool::Spare::Spare(Spare&&) = default;
+SpareRendererPool::Spare::~Spare() = default;
+SpareRendererPool::Spare& SpareRendererPool::Spare::operator=(Spare&&) =
+    default;
+
+// static
+int SpareRendererPool::kLocatorKey = 0;
+
+SpareRendererPool::SpareRendererPool(content::BrowserContext* context)
+    : context_(context), weak_factory_(this) {
+  context->SetUserData(&kLocatorKey, base::WrapUnique(this));
+}
+
+SpareRendererPool::~SpareRendererPool() {
+  Clear();
+}
+
+// static
+SpareRendererPool* SpareRendererPool::FromBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<SpareRendererPool*>(context->GetUserData(&kLocatorKey));
+}
+
+// static
+WebContentsPreferences* SpareRendererPool::GetPreferencesForProcess(
+    content::RenderProcessHost* host) {
+  SpareRendererPool* self = FromBrowserContext(host->GetBrowserContext());
+  if (!self)
+    return nullptr;
+
+  for (const auto& spare : self->spares_) {
+    if (spare.process_id == host->GetID())
+      return self->web_preferences_.get();
+  }
+  return nullptr;
+}
+
+// static
+base::CommandLine::StringVector SpareRendererPool::GetRendererSwitches(
+    content::BrowserContext* context,
+    WebContentsPreferences* web_preferences) {
+  base::CommandLine command_line(base::CommandLine::NO_PROGRAM);
+  // The preferences decide whether to disable the sandbox by looking at it.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableSandbox))
+    command_line.AppendSwitch(switches::kEnableSandbox);
+  web_preferences->AppendCommandLineSwitches(&command_line);
+  SessionPreferences::AppendExtraCommandLineSwitches(context, &command_line);
+  return command_line.argv();
+}
+
+void SpareRendererPool::SetOptions(size_t size,
+                                   const mate::Dictionary& web_preferences) {
+  Clear();
+  size_ = size;
+  relaunches_ = 0;
+  web_preferences_ = std::make_unique<WebContentsPreferences>(web_preferences);
+  Refill();
+}
+
+content::SiteInstance* SpareRendererPool::TakeSpare(
+    WebContentsPreferences* web_preferences) {
+  if (spares_.empty())
+    return nullptr;
+
+  auto switches = GetRendererSwitches(context_, web_preferences);
+  auto iter = std::find_if(
+      spares_.begin(), spares_.end(), [&switches](const Spare& spare) {
+        if (spare.switches != switches)
+          return false;
+        auto* process = content::RenderProcessHost::FromID(spare.process_id);
+        return process && process->IsInitializedAndNotDead() &&
+               process->IsUnused();
+      });
+  if (iter == spares_.end())
+    return nullptr;
+
+  content::RenderProcessHost::FromID(iter->process_id)->RemoveObserver(this);
+  taken_.push_back(std::move(iter->site_instance));
+  spares_.erase(iter);
+  relaunches_ = 0;
+  ScheduleRefill();
+  return taken_.back().get();
+}
+
+std::vector<base::ProcessId> SpareRendererPool::GetProcessIds() const {
+  std::vector<base::ProcessId> pids;
+  for (const auto& spare : spares_) {
+    auto* host = content::RenderProcessHost::FromID(spare.process_id);
+    if (host && host->GetProcess().IsValid())
+      pids.push_back(host->GetProcess().Pid());
+  }
+  return pids;
+}
+
+void SpareRendererPool::RenderProcessExited(
+    content::RenderProcessHost* host,
+    const content::ChildProcessTerminationInfo& info) {
+  if (!RemoveSpare(host))
+    return;
+
+  // Spares only exit on their own when they crash or are killed.
+  if (info.status != base::TERMINATION_STATUS_NORMAL_TERMINATION &&
+      relaunches_ < kMaxRelaunches) {
+    ++relaunches_;
+    ScheduleRefill();
+  }
+}
+
+void SpareRendererPool::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  RemoveSpare(host);
+}
+
+void SpareRendererPool::Refill() {
+  taken_.clear();
+  while (spares_.size() < size_) {
+    Spare spare;
+    spare.site_instance = content::SiteInstance::Create(context_);
+    auto* process = spare.site_instance->GetProcess();
+    // Over the process limit an existing renderer is returned, which was not
+    // launched for the pool.
+    if (process->IsInitializedAndNotDead())
+      break;
+
+    spare.process_id = process->GetID();
+    spare.switches = GetRendererSwitches(context_, web_preferences_.get());
+    // The spare has to be known before launching, as the command line of the
+    // renderer is built from the preferences of the pool.
+    spares_.push_back(std::move(spare));
+    process->AddObserver(this);
+    if (!process->Init()) {
+      RemoveSpare(process);
+      break;
+    }
+  }
+}
+
+void SpareRendererPool::ScheduleRefill() {
+  // Launch the replacements after the navigation that took a spare has moved
+  // on, they are not needed before the next window.
+  base::PostTaskWithTraits(FROM_HERE, {content::BrowserThread::UI},
+                           base::BindOnce(&SpareRendererPool::Refill,
+                                          weak_factory_.GetWeakPtr()));
+}
+
+bool SpareRendererPool::RemoveSpare(content::RenderProcessHost* host) {
+  auto iter = std::find_if(
+      spares_.begin(), spares_.end(), [host](const Spare& spare) {
+        return spare.process_id == host->GetID();
+      });
+  if (iter == spares_.end())
+    return false;
+
+  host->RemoveObserver(this);
+  spares_.erase(iter);
+  return true;
+}
+
+void SpareRendererPool::Clear() {
+  for (const auto& spare : spares_) {
+    auto* host = content::RenderProcessHost::FromID(spare.process_id);
+    if (host)
+      host->RemoveObserver(this);
+  }
+  // Releasing the SiteInstances shuts down the renderers nothing uses.
+  spares_.clear();
+  taken_.clear();
+}
+
+}  // namespace atom
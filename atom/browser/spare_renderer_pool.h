@@ -0,0 +1,112 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_SPARE_RENDERER_POOL_H_
+#define ATOM_BROWSER_SPARE_RENDERER_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/supports_user_data.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+class SiteInstance;
+}  // namespace content
+
+namespace mate {
+class Dictionary;
+}
+
+namespace atom {
+
+class WebContentsPreferences;
+
+// Keeps renderer processes of a session launched ahead of time, so the first
+// navigation of a new window with compatible webPreferences does not have to
+// wait for a renderer process to start.
+class SpareRendererPool : public base::SupportsUserData::Data,
+                          public content::RenderProcessHostObserver {
+ public:
+  static SpareRendererPool* FromBrowserContext(
+      content::BrowserContext* context);
+
+  // Returns the preferences the spare renderer |host| was launched with.
+  static WebContentsPreferences* GetPreferencesForProcess(
+      content::RenderProcessHost* host);
+
+  // Returns the switches |web_preferences| add to a renderer's command line,
+  // a spare renderer is only used when they are the same as its own.
+  static base::CommandLine::StringVector GetRendererSwitches(
+      content::BrowserContext* context,
+      WebContentsPreferences* web_preferences);
+
+  explicit SpareRendererPool(content::BrowserContext* context);
+  ~SpareRendererPool() override;
+
+  // Keeps |size| renderers launched with |web_preferences|.
+  void SetOptions(size_t size, const mate::Dictionary& web_preferences);
+
+  // Removes a spare renderer that was launched with the same switches as
+  // |web_preferences| would use, and returns its SiteInstance.
+  content::SiteInstance* TakeSpare(WebContentsPreferences* web_preferences);
+
+  // Returns the pids of the spare renderers that have been launched.
+  std::vector<base::ProcessId> GetProcessIds() const;
+
+ protected:
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(
+      content::RenderProcessHost* host,
+      const content::ChildProcessTerminationInfo& info) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  struct Spare {
+    Spare();
+    Spare(Spare&&);
+    ~Spare();
+    Spare& operator=(Spare&&);
+
+    scoped_refptr<content::SiteInstance> site_instance;
+    int process_id = 0;
+    base::CommandLine::StringVector switches;
+  };
+
+  void Refill();
+  void ScheduleRefill();
+  // Returns whether |host| was a spare.
+  bool RemoveSpare(content::RenderProcessHost* host);
+  void Clear();
+
+  // The user data key.
+  static int kLocatorKey;
+
+  content::BrowserContext* context_;
+
+  size_t size_ = 0;
+  std::unique_ptr<WebContentsPreferences> web_preferences_;
+  std::vector<Spare> spares_;
+
+  // Spares relaunched after exiting unexpectedly since one was last taken.
+  int relaunches_ = 0;
+
+  // SiteInstances that were just given out, kept alive until the navigation
+  // that takes them holds its own reference.
+  std::vector<scoped_refptr<content::SiteInstance>> taken_;
+
+  base::WeakPtrFactory<SpareRendererPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererPool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_SPARE_RENDERER_POOL_H_
@@ -103,7 +103,16 @@ std::vector<WebContentsPreferences*> WebContentsPreferences::instances_;
 WebContentsPreferences::WebContentsPreferences(
     content::WebContents* web_contents,
     const mate::Dictionary& web_preferences)
-    : web_contents_(web_contents) {
+    : WebContentsPreferences(web_preferences) {
+  web_contents_ = web_contents;
+  web_contents->SetUserData(UserDataKey(), base::WrapUnique(this));
+
+  instances_.push_back(this);
+}
+
+WebContentsPreferences::WebContentsPreferences(
+    const mate::Dictionary& web_preferences)
+    : web_contents_(nullptr) {
   v8::Isolate* isolate = web_preferences.isolate();
   mate::Dictionary copied(isolate, web_preferences.GetHandle()->Clone());
   // Following fields should not be stored.
@@ -112,9 +121,6 @@ WebContentsPreferences::WebContentsPreferences(
   copied.Delete("session");
 
   mate::ConvertFromV8(isolate, copied.GetHandle(), &preference_);
-  web_contents->SetUserData(UserDataKey(), base::WrapUnique(this));
-
-  instances_.push_back(this);
 
   // Set WebPreferences defaults onto the JS object
   SetDefaultBoolIfUndefined(options::kPlugins, false);
@@ -347,7 +353,7 @@ void WebContentsPreferences::AppendCommandLineSwitches(
   if (GetAsString(&preference_, options::kDisableBlinkFeatures, &s))
     command_line->AppendSwitchASCII(::switches::kDisableBlinkFeatures, s);
 
-  if (guest_instance_id) {
+  if (guest_instance_id && web_contents_) {
     // Webview `document.visibilityState` tracks window visibility so we need
     // to let it know if the window happens to be hidden right now.
     auto* manager = WebViewManager::GetWebViewManager(web_contents_);
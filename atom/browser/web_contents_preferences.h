@@ -34,6 +34,9 @@ class WebContentsPreferences
 
   WebContentsPreferences(content::WebContents* web_contents,
                          const mate::Dictionary& web_preferences);
+  // Creates preferences that are not attached to any WebContents, which is
+  // used to launch renderer processes before their WebContents exist.
+  explicit WebContentsPreferences(const mate::Dictionary& web_preferences);
   ~WebContentsPreferences() override;
 
   // A simple way to know whether a Boolean property is enabled.
@@ -25,27 +25,38 @@ IPC_STRUCT_TRAITS_BEGIN(atom::DraggableRegion)
   IPC_STRUCT_TRAITS_MEMBER(bounds)
 IPC_STRUCT_TRAITS_END()
 
-IPC_MESSAGE_ROUTED3(AtomFrameHostMsg_Message,
+IPC_MESSAGE_ROUTED4(AtomFrameHostMsg_Message,
                     bool /* internal */,
                     std::string /* channel */,
-                    base::ListValue /* arguments */)
+                    base::ListValue /* arguments */,
+                    uint64_t /* trace_id */)
 
-IPC_SYNC_MESSAGE_ROUTED3_1(AtomFrameHostMsg_Message_Sync,
+IPC_SYNC_MESSAGE_ROUTED4_1(AtomFrameHostMsg_Message_Sync,
                            bool /* internal */,
                            std::string /* channel */,
                            base::ListValue /* arguments */,
+                           uint64_t /* trace_id */,
                            base::ListValue /* result */)
 
-IPC_MESSAGE_ROUTED5(AtomFrameHostMsg_Message_To,
+IPC_MESSAGE_ROUTED6(AtomFrameHostMsg_Message_To,
                     bool /* internal */,
                     bool /* send_to_all */,
                     int32_t /* web_contents_id */,
                     std::string /* channel */,
-                    base::ListValue /* arguments */)
+                    base::ListValue /* arguments */,
+                    uint64_t /* trace_id */)
 
-IPC_MESSAGE_ROUTED2(AtomFrameHostMsg_Message_Host,
+// Handled on the IO thread by DirectChannelMessageFilter.
+IPC_MESSAGE_ROUTED4(AtomFrameHostMsg_Message_Direct,
+                    int32_t /* channel_id */,
                     std::string /* channel */,
-                    base::ListValue /* arguments */)
+                    base::ListValue /* arguments */,
+                    uint64_t /* trace_id */)
+
+IPC_MESSAGE_ROUTED3(AtomFrameHostMsg_Message_Host,
+                    std::string /* channel */,
+                    base::ListValue /* arguments */,
+                    uint64_t /* trace_id */)
 
 IPC_MESSAGE_ROUTED5(AtomFrameMsg_Message,
                     bool /* internal */,
@@ -86,6 +97,7 @@ IPC_MESSAGE_ROUTED2(AtomFrameHostMsg_PDFSaveURLAs,
                     GURL /* url */,
                     content::Referrer /* referrer */)
 
-IPC_MESSAGE_ROUTED2(AtomFrameMsg_TakeHeapSnapshot,
+IPC_MESSAGE_ROUTED3(AtomFrameMsg_TakeHeapSnapshot,
                     IPC::PlatformFileForTransit /* file_handle */,
-                    std::string /* channel */)
+                    std::string /* channel */,
+                    bool /* gzip */)
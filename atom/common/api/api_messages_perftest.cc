@@ -0,0 +1,82 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace atom {
+
+namespace {
+
+const int kIterations = 100;
+const int kTargets = 50;
+
+// A payload the size of a typical state update pushed to many windows.
+base::ListValue CreatePayload() {
+  base::ListValue args;
+  auto items = std::make_unique<base::ListValue>();
+  for (int i = 0; i < 1000; ++i) {
+    auto item = std::make_unique<base::DictionaryValue>();
+    item->SetInteger("id", i);
+    item->SetString("title", "item" + base::NumberToString(i));
+    item->SetDouble("progress", i / 1000.0);
+    items->Append(std::move(item));
+  }
+  args.Append(std::move(items));
+  return args;
+}
+
+}  // namespace
+
+// What sending to each target with contents.send costs: the arguments are
+// pickled for every target.
+TEST(BroadcastPerfTest, SerializePerTarget) {
+  base::ListValue args = CreatePayload();
+  size_t bytes = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (int target = 0; target < kTargets; ++target) {
+      AtomFrameMsg_Message message(target, false, false, "update", args, 0);
+      bytes += message.size();
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_GT(bytes, 0u);
+  perf_test::PrintResult("broadcast", "_serialize_per_target", "50_targets",
+                         elapsed.InMillisecondsF() / kIterations, "ms", true);
+}
+
+// What webContents.broadcast costs: the arguments are pickled once and each
+// target gets a copy with its routing ID.
+TEST(BroadcastPerfTest, SerializeOnce) {
+  base::ListValue args = CreatePayload();
+  size_t bytes = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    AtomFrameMsg_Message message(MSG_ROUTING_NONE, false, false, "update",
+                                 args, 0);
+    for (int target = 0; target < kTargets; ++target) {
+      IPC::Message copy(message);
+      copy.set_routing_id(target);
+      bytes += copy.size();
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_GT(bytes, 0u);
+  perf_test::PrintResult("broadcast", "_serialize_once", "50_targets",
+                         elapsed.InMillisecondsF() / kIterations, "ms", true);
+}
+
+}  // namespace atom
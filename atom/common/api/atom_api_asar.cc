@@ -4,11 +4,17 @@
 
 #include <stddef.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_util.h"
+#include "base/threading/thread_restrictions.h"
 #include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -23,8 +29,9 @@ class Archive : public mate::Wrappable<Archive> {
  public:
   static v8::Local<v8::Value> Create(v8::Isolate* isolate,
                                      const base::FilePath& path) {
-    auto archive = std::make_unique<asar::Archive>(path);
-    if (!archive->Init())
+    // Share the parsed header with the native module resolution hooks.
+    std::shared_ptr<asar::Archive> archive = asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return v8::False(isolate);
     return (new Archive(isolate, std::move(archive)))->GetWrapper();
   }
@@ -43,7 +50,7 @@ class Archive : public mate::Wrappable<Archive> {
   }
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
       : archive_(std::move(archive)) {
     Init(isolate);
   }
@@ -113,11 +120,122 @@ class Archive : public mate::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
+enum class PathKind {
+  kNotInArchive,
+  kInArchive,
+  // The path has to be normalized by asar.js first.
+  kNotNormalized,
+};
+
+// Splits |path| at its last ".asar" component like splitPath in asar.js, in
+// one pass and without normalizing it.
+PathKind SplitAsarPath(const base::FilePath& path,
+                       base::FilePath* asar_path,
+                       base::FilePath* file_path) {
+  const base::FilePath::StringType& value = path.value();
+  const base::FilePath::StringPieceType kAsarExtension =
+      FILE_PATH_LITERAL(".asar");
+  if (base::EndsWith(value, kAsarExtension, base::CompareCase::SENSITIVE)) {
+    *asar_path = path;
+    *file_path = base::FilePath();
+    return PathKind::kInArchive;
+  }
+
+  size_t split = base::FilePath::StringType::npos;
+  size_t start = 0;
+  for (size_t i = 0; i <= value.size(); ++i) {
+    bool at_end = i == value.size();
+    if (!at_end && !base::FilePath::IsSeparator(value[i]))
+      continue;
+
+    base::FilePath::StringPieceType component(value.data() + start, i - start);
+    // Leading separators are part of the root, as in UNC paths.
+    if (component == FILE_PATH_LITERAL(".") ||
+        component == FILE_PATH_LITERAL("..") ||
+        (component.empty() && start > 1 && !at_end))
+      return PathKind::kNotNormalized;
+    if (!at_end && base::EndsWith(component, kAsarExtension,
+                                  base::CompareCase::SENSITIVE))
+      split = i;
+    start = i + 1;
+  }
+  if (split == base::FilePath::StringType::npos)
+    return PathKind::kNotInArchive;
+
+  *asar_path = base::FilePath(value.substr(0, split));
+  *file_path = base::FilePath(value.substr(split + 1));
+  return PathKind::kInArchive;
+}
+
+// Native versions of the internalModuleStat and internalModuleReadJSON hooks
+// in asar.js, which Node calls for every candidate path of a require(). They
+// return false for paths outside archives, and null for paths asar.js has to
+// handle itself.
+
+v8::Local<v8::Value> InternalModuleStat(v8::Isolate* isolate,
+                                        v8::Local<v8::Value> value) {
+  base::FilePath path, asar_path, file_path;
+  if (!value->IsString() || !mate::ConvertFromV8(isolate, value, &path))
+    return v8::Null(isolate);
+  switch (SplitAsarPath(path, &asar_path, &file_path)) {
+    case PathKind::kNotInArchive:
+      return v8::False(isolate);
+    case PathKind::kNotNormalized:
+      return v8::Null(isolate);
+    case PathKind::kInArchive:
+      break;
+  }
+
+  // Same error code as the JavaScript version.
+  const int kNotFound = -34;
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  asar::Archive::Stats stats;
+  if (!archive || !archive->Stat(file_path, &stats))
+    return v8::Integer::New(isolate, kNotFound);
+  return v8::Integer::New(isolate, stats.is_directory ? 1 : 0);
+}
+
+v8::Local<v8::Value> InternalModuleReadJSON(v8::Isolate* isolate,
+                                            v8::Local<v8::Value> value) {
+  base::FilePath path, asar_path, file_path;
+  if (!value->IsString() || !mate::ConvertFromV8(isolate, value, &path))
+    return v8::Null(isolate);
+  switch (SplitAsarPath(path, &asar_path, &file_path)) {
+    case PathKind::kNotInArchive:
+      return v8::False(isolate);
+    case PathKind::kNotNormalized:
+      return v8::Null(isolate);
+    case PathKind::kInArchive:
+      break;
+  }
+
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  asar::Archive::FileInfo info;
+  if (!archive || !archive->GetFileInfo(file_path, &info))
+    return v8::Undefined(isolate);
+
+  std::string contents;
+  if (info.unpacked) {
+    base::FilePath real_path;
+    // For unpacked file it will return the real path instead of doing the copy.
+    if (!archive->CopyFileOut(file_path, &real_path))
+      return v8::Undefined(isolate);
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (!base::ReadFileToString(real_path, &contents))
+      return v8::Undefined(isolate);
+  } else if (!archive->ReadFile(info, &contents)) {
+    return v8::Undefined(isolate);
+  }
+  return mate::StringToV8(isolate, contents);
+}
+
 void InitAsarSupport(v8::Isolate* isolate,
                      v8::Local<v8::Value> source,
                      v8::Local<v8::Value> require) {
@@ -140,6 +258,8 @@ void Initialize(v8::Local<v8::Object> exports,
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createArchive", &Archive::Create);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
+  dict.SetMethod("internalModuleStat", &InternalModuleStat);
+  dict.SetMethod("internalModuleReadJSON", &InternalModuleReadJSON);
 }
 
 }  // namespace
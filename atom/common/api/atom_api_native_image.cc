@@ -9,17 +9,24 @@
 #include <utility>
 #include <vector>
 
+#include "atom/common/api/locker.h"
 #include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/promise_util.h"
+#include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -81,12 +88,8 @@ float GetScaleFactorFromOptions(mate::Arguments* args) {
   return scale_factor;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const unsigned char* data,
-                     size_t size,
-                     int width,
-                     int height,
-                     double scale_factor) {
+// Decode |data| as PNG or JPEG.
+std::unique_ptr<SkBitmap> DecodeImage(const unsigned char* data, size_t size) {
   auto decoded = std::make_unique<SkBitmap>();
 
   // Try PNG first.
@@ -104,7 +107,16 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
       decoded->setAlphaType(SkAlphaType::kOpaque_SkAlphaType);
     }
   }
+  return decoded;
+}
 
+bool AddImageSkiaRep(gfx::ImageSkia* image,
+                     const unsigned char* data,
+                     size_t size,
+                     int width,
+                     int height,
+                     double scale_factor) {
+  auto decoded = DecodeImage(data, size);
   if (!decoded) {
     // Try Bitmap
     if (width > 0 && height > 0) {
@@ -206,6 +218,167 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
 
 void Noop(char*, void*) {}
 
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const base::DictionaryValue& options) {
+  std::string quality;
+  options.GetString("quality", &quality);
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
+// The bitmaps of an image, gfx::ImageSkia can not be passed between threads
+// so the asynchronous methods work on the bitmaps directly.
+struct ImageRep {
+  SkBitmap bitmap;
+  float scale;
+};
+using ImageReps = std::vector<ImageRep>;
+
+ImageReps GetImageReps(const gfx::Image& image) {
+  ImageReps reps;
+  for (const auto& rep : image.AsImageSkia().image_reps())
+    reps.push_back({rep.GetBitmap(), rep.scale()});
+  return reps;
+}
+
+template <typename Result>
+void PostImageTask(base::OnceCallback<Result()> task,
+                   base::OnceCallback<void(Result)> reply) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      std::move(task), std::move(reply));
+}
+
+scoped_refptr<base::RefCountedMemory> EncodePNGInBackground(
+    const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+scoped_refptr<base::RefCountedMemory> EncodeJPEGInBackground(
+    const SkBitmap& bitmap,
+    int quality) {
+  std::vector<unsigned char> encoded;
+  gfx::JPEGCodec::Encode(bitmap, quality, &encoded);
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+std::string EncodeDataURLInBackground(
+    const SkBitmap& bitmap,
+    scoped_refptr<base::RefCountedMemory> png) {
+  if (png && png->size() > 0)
+    return webui::GetPngDataUrl(png->front(), png->size());
+  return webui::GetBitmapDataUrl(bitmap);
+}
+
+ImageReps ResizeInBackground(ImageReps reps,
+                             const gfx::Size& size,
+                             skia::ImageOperations::ResizeMethod method) {
+  if (size.IsEmpty())
+    return ImageReps();
+  for (auto& rep : reps) {
+    gfx::Size scaled = gfx::ScaleToCeiledSize(size, rep.scale);
+    rep.bitmap = skia::ImageOperations::Resize(rep.bitmap, method,
+                                               scaled.width(), scaled.height());
+  }
+  return reps;
+}
+
+void ReadImageRep(const base::FilePath& path, float scale, ImageReps* reps) {
+  std::string file_contents;
+  if (!asar::ReadFileToString(path, &file_contents))
+    return;
+
+  auto decoded = DecodeImage(
+      reinterpret_cast<const unsigned char*>(file_contents.data()),
+      file_contents.size());
+  if (decoded)
+    reps->push_back({*decoded, scale});
+}
+
+// Same lookup of the scaled representations as PopulateImageSkiaRepsFromPath.
+ImageReps ReadImageRepsFromPath(const base::FilePath& path) {
+  ImageReps reps;
+  base::FilePath image_path = NormalizePath(path);
+  std::string filename(image_path.BaseName().RemoveExtension().AsUTF8Unsafe());
+  if (base::MatchPattern(filename, "*@*x")) {
+    ReadImageRep(image_path, GetScaleFactorFromPath(image_path), &reps);
+    return reps;
+  }
+
+  ReadImageRep(image_path, 1.0f, &reps);
+  for (const ScaleFactorPair& pair : kScaleFactorPairs)
+    ReadImageRep(image_path.InsertBeforeExtensionASCII(pair.name), pair.scale,
+                 &reps);
+  return reps;
+}
+
+ImageReps DecodeBufferInBackground(const std::string& data,
+                                   int width,
+                                   int height,
+                                   float scale) {
+  ImageReps reps;
+  auto decoded = DecodeImage(
+      reinterpret_cast<const unsigned char*>(data.data()), data.size());
+  if (decoded) {
+    reps.push_back({*decoded, scale});
+  } else if (width > 0 && height > 0) {
+    // Unlike the synchronous version the pixels have to be copied, since the
+    // buffer does not outlive this task.
+    SkBitmap bitmap;
+    if (bitmap.tryAllocN32Pixels(width, height, false) &&
+        bitmap.computeByteSize() <= data.size()) {
+      memcpy(bitmap.getPixels(), data.data(), bitmap.computeByteSize());
+      reps.push_back({bitmap, scale});
+    }
+  }
+  return reps;
+}
+
+void ResolveWithBuffer(scoped_refptr<util::Promise> promise,
+                       scoped_refptr<base::RefCountedMemory> data) {
+  v8::Isolate* isolate = promise->isolate();
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise->GetContext());
+
+  v8::Local<v8::Value> buffer;
+  if (data->size() == 0)
+    buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+  else
+    buffer = node::Buffer::Copy(isolate, data->front_as<char>(), data->size())
+                 .ToLocalChecked();
+  promise->Resolve(buffer);
+}
+
+void ResolveWithString(scoped_refptr<util::Promise> promise,
+                       std::string result) {
+  promise->Resolve(result);
+}
+
+void ResolveWithImage(scoped_refptr<util::Promise> promise,
+                      bool is_template,
+                      ImageReps reps) {
+  v8::Isolate* isolate = promise->isolate();
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise->GetContext());
+
+  gfx::ImageSkia image_skia;
+  for (const auto& rep : reps)
+    image_skia.AddRepresentation(gfx::ImageSkiaRep(rep.bitmap, rep.scale));
+  auto handle = NativeImage::Create(isolate, gfx::Image(image_skia));
+  if (is_template)
+    handle->SetTemplateImage(true);
+  promise->Resolve(handle);
+}
+
 }  // namespace
 
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
@@ -350,6 +523,55 @@ v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
 #endif
 }
 
+v8::Local<v8::Promise> NativeImage::ToPNGAsync(mate::Arguments* args) {
+  scoped_refptr<util::Promise> promise = new util::Promise(args->isolate());
+  float scale_factor = GetScaleFactorFromOptions(args);
+
+  if (scale_factor == 1.0f) {
+    // Use raw 1x PNG bytes when available
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    if (png->size() > 0) {
+      base::ThreadTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&ResolveWithBuffer, promise, png));
+      return promise->GetHandle();
+    }
+  }
+
+  PostImageTask(
+      base::BindOnce(
+          &EncodePNGInBackground,
+          image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap()),
+      base::BindOnce(&ResolveWithBuffer, promise));
+  return promise->GetHandle();
+}
+
+v8::Local<v8::Promise> NativeImage::ToJPEGAsync(v8::Isolate* isolate,
+                                                int quality) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+  PostImageTask(base::BindOnce(&EncodeJPEGInBackground,
+                               image_.AsImageSkia().GetRepresentation(1.0f)
+                                   .GetBitmap(),
+                               quality),
+                base::BindOnce(&ResolveWithBuffer, promise));
+  return promise->GetHandle();
+}
+
+v8::Local<v8::Promise> NativeImage::ToDataURLAsync(mate::Arguments* args) {
+  scoped_refptr<util::Promise> promise = new util::Promise(args->isolate());
+  float scale_factor = GetScaleFactorFromOptions(args);
+
+  scoped_refptr<base::RefCountedMemory> png;
+  SkBitmap bitmap;
+  if (scale_factor == 1.0f)
+    png = image_.As1xPNGBytes();
+  if (!png || png->size() == 0)
+    bitmap = image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap();
+
+  PostImageTask(base::BindOnce(&EncodeDataURLInBackground, bitmap, png),
+                base::BindOnce(&ResolveWithString, promise));
+  return promise->GetHandle();
+}
+
 bool NativeImage::IsEmpty() {
   return image_.IsEmpty();
 }
@@ -366,9 +588,7 @@ float NativeImage::GetAspectRatio() {
     return static_cast<float>(size.width()) / static_cast<float>(size.height());
 }
 
-mate::Handle<NativeImage> NativeImage::Resize(
-    v8::Isolate* isolate,
-    const base::DictionaryValue& options) {
+gfx::Size NativeImage::GetResizedSize(const base::DictionaryValue& options) {
   gfx::Size size = GetSize();
   int width = size.width();
   int height = size.height();
@@ -385,22 +605,29 @@ mate::Handle<NativeImage> NativeImage::Resize(
     size.set_width(height);
     size = gfx::ScaleToRoundedSize(size, GetAspectRatio(), 1.f);
   }
+  return size;
+}
 
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
-  std::string quality;
-  options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
-
+mate::Handle<NativeImage> NativeImage::Resize(
+    v8::Isolate* isolate,
+    const base::DictionaryValue& options) {
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(options), GetResizedSize(options));
   return mate::CreateHandle(isolate,
                             new NativeImage(isolate, gfx::Image(resized)));
 }
 
+v8::Local<v8::Promise> NativeImage::ResizeAsync(
+    v8::Isolate* isolate,
+    const base::DictionaryValue& options) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+  PostImageTask(base::BindOnce(&ResizeInBackground, GetImageReps(image_),
+                               GetResizedSize(options),
+                               GetResizeMethod(options)),
+                base::BindOnce(&ResolveWithImage, promise, false));
+  return promise->GetHandle();
+}
+
 mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                                             const gfx::Rect& rect) {
   gfx::ImageSkia cropped =
@@ -541,6 +768,57 @@ mate::Handle<NativeImage> NativeImage::CreateFromDataURL(v8::Isolate* isolate,
   return CreateEmpty(isolate);
 }
 
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromPathAsync(
+    v8::Isolate* isolate,
+    const base::FilePath& path) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+#if defined(OS_WIN)
+  // Icons are loaded lazily by size through LoadImage.
+  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    ImageReps reps = GetImageReps(CreateFromPath(isolate, path)->image());
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&ResolveWithImage, promise, false, reps));
+    return promise->GetHandle();
+  }
+#endif
+  bool is_template = false;
+#if defined(OS_MACOSX)
+  is_template = IsTemplateFilename(path);
+#endif
+  PostImageTask(base::BindOnce(&ReadImageRepsFromPath, path),
+                base::BindOnce(&ResolveWithImage, promise, is_template));
+  return promise->GetHandle();
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromBufferAsync(
+    mate::Arguments* args,
+    v8::Local<v8::Value> buffer) {
+  scoped_refptr<util::Promise> promise = new util::Promise(args->isolate());
+  if (!node::Buffer::HasInstance(buffer)) {
+    promise->RejectWithErrorMessage("buffer must be a node Buffer");
+    return promise->GetHandle();
+  }
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("width", &width);
+    options.Get("height", &height);
+    options.Get("scaleFactor", &scale_factor);
+  }
+
+  std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+  PostImageTask(base::BindOnce(&DecodeBufferInBackground, std::move(data),
+                               width, height, scale_factor),
+                base::BindOnce(&ResolveWithImage, promise, false));
+  return promise->GetHandle();
+}
+
 #if !defined(OS_MACOSX)
 mate::Handle<NativeImage> NativeImage::CreateFromNamedImage(
     mate::Arguments* args,
@@ -555,16 +833,20 @@ void NativeImage::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(mate::StringToV8(isolate, "NativeImage"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("toPNG", &NativeImage::ToPNG)
+      .SetMethod("_toPNGAsync", &NativeImage::ToPNGAsync)
       .SetMethod("toJPEG", &NativeImage::ToJPEG)
+      .SetMethod("_toJPEGAsync", &NativeImage::ToJPEGAsync)
       .SetMethod("toBitmap", &NativeImage::ToBitmap)
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getNativeHandle", &NativeImage::GetNativeHandle)
       .SetMethod("toDataURL", &NativeImage::ToDataURL)
+      .SetMethod("_toDataURLAsync", &NativeImage::ToDataURLAsync)
       .SetMethod("isEmpty", &NativeImage::IsEmpty)
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
       .SetMethod("isTemplateImage", &NativeImage::IsTemplateImage)
       .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("_resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("crop", &NativeImage::Crop)
       .SetMethod("getAspectRatio", &NativeImage::GetAspectRatio)
       .SetMethod("addRepresentation", &NativeImage::AddRepresentation);
@@ -615,6 +897,10 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
   dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
+  dict.SetMethod("_createFromPathAsync",
+                 &atom::api::NativeImage::CreateFromPathAsync);
+  dict.SetMethod("_createFromBufferAsync",
+                 &atom::api::NativeImage::CreateFromBufferAsync);
   dict.SetMethod("createFromDataURL",
                  &atom::api::NativeImage::CreateFromDataURL);
   dict.SetMethod("createFromNamedImage",
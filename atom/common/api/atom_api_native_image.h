@@ -60,6 +60,14 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       mate::Arguments* args,
       const std::string& name);
 
+  // Variants of CreateFromPath and CreateFromBuffer that read and decode the
+  // image on the thread pool.
+  static v8::Local<v8::Promise> CreateFromPathAsync(v8::Isolate* isolate,
+                                                    const base::FilePath& path);
+  static v8::Local<v8::Promise> CreateFromBufferAsync(
+      mate::Arguments* args,
+      v8::Local<v8::Value> buffer);
+
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
@@ -69,6 +77,11 @@ class NativeImage : public mate::Wrappable<NativeImage> {
 
   const gfx::Image& image() const { return image_; }
 
+  // Mark the image as template image.
+  void SetTemplateImage(bool setAsTemplate);
+  // Determine if the image is a template image.
+  bool IsTemplateImage();
+
  protected:
   NativeImage(v8::Isolate* isolate, const gfx::Image& image);
 #if defined(OS_WIN)
@@ -87,16 +100,21 @@ class NativeImage : public mate::Wrappable<NativeImage> {
                                    const base::DictionaryValue& options);
   mate::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   std::string ToDataURL(mate::Arguments* args);
+
+  // Variants of the encoders and of Resize that do the work on the thread
+  // pool and resolve the returned promise on the calling thread.
+  v8::Local<v8::Promise> ToPNGAsync(mate::Arguments* args);
+  v8::Local<v8::Promise> ToJPEGAsync(v8::Isolate* isolate, int quality);
+  v8::Local<v8::Promise> ToDataURLAsync(mate::Arguments* args);
+  v8::Local<v8::Promise> ResizeAsync(v8::Isolate* isolate,
+                                     const base::DictionaryValue& options);
+
   bool IsEmpty();
   gfx::Size GetSize();
+  gfx::Size GetResizedSize(const base::DictionaryValue& options);
   float GetAspectRatio();
   void AddRepresentation(const mate::Dictionary& options);
 
-  // Mark the image as template image.
-  void SetTemplateImage(bool setAsTemplate);
-  // Determine if the image is a template image.
-  bool IsTemplateImage();
-
 #if defined(OS_WIN)
   base::FilePath hicon_path_;
   std::map<int, base::win::ScopedHICON> hicons_;
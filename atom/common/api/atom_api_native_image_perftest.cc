@@ -0,0 +1,90 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+// NativeImage's encoders and Resize are thin wrappers around these codecs and
+// skia::ImageOperations, which is where the time goes, so they are measured
+// directly instead of through a wrapped JS object.
+
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "skia/ext/image_operations.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+
+namespace atom {
+
+namespace {
+
+const int kIterations = 10;
+
+// A 1920x1080 bitmap with gradients, so the encoders have actual work to do.
+SkBitmap CreateBitmap() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1920, 1080);
+  for (int y = 0; y < bitmap.height(); ++y) {
+    for (int x = 0; x < bitmap.width(); ++x) {
+      *bitmap.getAddr32(x, y) =
+          SkColorSetARGB(255, x % 256, y % 256, (x + y) % 256);
+    }
+  }
+  return bitmap;
+}
+
+void PrintTime(const std::string& modifier,
+               base::TimeDelta elapsed,
+               const std::string& trace) {
+  perf_test::PrintResult("native_image", modifier, trace,
+                         elapsed.InMillisecondsF() / kIterations, "ms", true);
+}
+
+}  // namespace
+
+TEST(NativeImagePerfTest, EncodePNG) {
+  SkBitmap bitmap = CreateBitmap();
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    std::vector<unsigned char> encoded;
+    ASSERT_TRUE(gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded));
+  }
+  PrintTime("_to_png", base::TimeTicks::Now() - start, "1080p");
+}
+
+TEST(NativeImagePerfTest, EncodeJPEG) {
+  SkBitmap bitmap = CreateBitmap();
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    std::vector<unsigned char> encoded;
+    ASSERT_TRUE(gfx::JPEGCodec::Encode(bitmap, 90, &encoded));
+  }
+  PrintTime("_to_jpeg", base::TimeTicks::Now() - start, "1080p");
+}
+
+TEST(NativeImagePerfTest, Resize) {
+  SkBitmap bitmap = CreateBitmap();
+  const struct {
+    skia::ImageOperations::ResizeMethod method;
+    const char* trace;
+  } kMethods[] = {
+      {skia::ImageOperations::RESIZE_GOOD, "1080p_to_720p_good"},
+      {skia::ImageOperations::RESIZE_BETTER, "1080p_to_720p_better"},
+      {skia::ImageOperations::RESIZE_BEST, "1080p_to_720p_best"},
+  };
+
+  for (const auto& method : kMethods) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; ++i) {
+      SkBitmap resized =
+          skia::ImageOperations::Resize(bitmap, method.method, 1280, 720);
+      ASSERT_EQ(1280, resized.width());
+    }
+    PrintTime("_resize", base::TimeTicks::Now() - start, method.trace);
+  }
+}
+
+}  // namespace atom
@@ -15,19 +15,24 @@
 #include "atom/common/application_info.h"
 #include "atom/common/atom_version.h"
 #include "atom/common/heap_snapshot.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/profile_util.h"
 #include "atom/common/promise_util.h"
 #include "base/logging.h"
 #include "base/process/process.h"
 #include "base/process/process_handle.h"
 #include "base/process/process_metrics_iocounters.h"
 #include "base/system/sys_info.h"
+#include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
 #include "chrome/common/chrome_version.h"
 #include "native_mate/dictionary.h"
 #include "services/resource_coordinator/public/cpp/memory_instrumentation/global_memory_dump.h"
 #include "services/resource_coordinator/public/cpp/memory_instrumentation/memory_instrumentation.h"
+#include "v8/include/v8-profiler.h"
 
 // Must be the last in the includes list, otherwise the definition of chromium
 // macros conflicts with node macros.
@@ -37,6 +42,9 @@ namespace atom {
 
 namespace {
 
+// Title of the CPU profile recorded by process.startCpuProfile.
+const char kCpuProfileTitle[] = "electron";
+
 // Dummy class type that used for crashing the program.
 struct DummyClass {
   bool crash;
@@ -58,6 +66,8 @@ AtomBindings::AtomBindings(uv_loop_t* loop) {
 }
 
 AtomBindings::~AtomBindings() {
+  if (cpu_profiler_)
+    cpu_profiler_->Dispose();
   uv_close(reinterpret_cast<uv_handle_t*>(&call_next_tick_async_), nullptr);
 }
 
@@ -94,11 +104,22 @@ void AtomBindings::BindTo(v8::Isolate* isolate, v8::Local<v8::Object> process) {
   BindProcess(isolate, &dict, metrics_.get());
 
   dict.SetMethod("takeHeapSnapshot", &TakeHeapSnapshot);
+  dict.SetMethod("writeHeapSnapshot", &WriteHeapSnapshot);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::IncreaseFdLimitTo);
 #endif
   dict.SetMethod("activateUvLoop", base::Bind(&AtomBindings::ActivateUVLoop,
                                               base::Unretained(this)));
+  dict.SetMethod("startCpuProfile", base::Bind(&AtomBindings::StartCpuProfile,
+                                               base::Unretained(this)));
+  dict.SetMethod("stopCpuProfile", base::Bind(&AtomBindings::StopCpuProfile,
+                                              base::Unretained(this)));
+  dict.SetMethod("startSamplingHeapProfile",
+                 base::Bind(&AtomBindings::StartSamplingHeapProfile,
+                            base::Unretained(this)));
+  dict.SetMethod("stopSamplingHeapProfile",
+                 base::Bind(&AtomBindings::StopSamplingHeapProfile,
+                            base::Unretained(this)));
 
   mate::Dictionary versions;
   if (dict.Get("versions", &versions)) {
@@ -124,6 +145,122 @@ void AtomBindings::ActivateUVLoop(v8::Isolate* isolate) {
   uv_async_send(&call_next_tick_async_);
 }
 
+void AtomBindings::StartCpuProfile(mate::Arguments* args) {
+  if (cpu_profiler_) {
+    args->ThrowError("A CPU profile is already being recorded");
+    return;
+  }
+
+  // In microseconds, same as the default of V8.
+  int sampling_interval = 1000;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("samplingInterval", &sampling_interval);
+  if (sampling_interval <= 0) {
+    args->ThrowError("samplingInterval must be a positive number");
+    return;
+  }
+
+  v8::Isolate* isolate = args->isolate();
+  cpu_profiler_ = v8::CpuProfiler::New(isolate);
+  cpu_profiler_->SetSamplingInterval(sampling_interval);
+  cpu_profiler_->StartProfiling(mate::StringToV8(isolate, kCpuProfileTitle),
+                                true /* record_samples */);
+}
+
+v8::Local<v8::Promise> AtomBindings::StopCpuProfile(v8::Isolate* isolate) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+  if (!cpu_profiler_) {
+    promise->RejectWithErrorMessage("No CPU profile is being recorded");
+    return promise->GetHandle();
+  }
+
+  std::unique_ptr<base::Value> value;
+  v8::CpuProfile* profile = cpu_profiler_->StopProfiling(
+      mate::StringToV8(isolate, kCpuProfileTitle));
+  if (profile) {
+    value = CpuProfileToValue(profile);
+    profile->Delete();
+  }
+  cpu_profiler_->Dispose();
+  cpu_profiler_ = nullptr;
+
+  if (value)
+    ResolveWithProfile(promise, std::move(value));
+  else
+    promise->RejectWithErrorMessage("Failed to record CPU profile");
+  return promise->GetHandle();
+}
+
+void AtomBindings::StartSamplingHeapProfile(mate::Arguments* args) {
+  if (sampling_heap_profiling_) {
+    args->ThrowError("A sampling heap profile is already being recorded");
+    return;
+  }
+
+  // Average number of bytes between samples, same as the defaults of V8.
+  uint64_t sampling_interval = 512 * 1024;
+  int stack_depth = 16;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("samplingInterval", &sampling_interval);
+    options.Get("stackDepth", &stack_depth);
+  }
+
+  if (!args->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+          sampling_interval, stack_depth)) {
+    args->ThrowError("Failed to start the sampling heap profiler");
+    return;
+  }
+  sampling_heap_profiling_ = true;
+}
+
+v8::Local<v8::Promise> AtomBindings::StopSamplingHeapProfile(
+    v8::Isolate* isolate) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+  if (!sampling_heap_profiling_) {
+    promise->RejectWithErrorMessage(
+        "No sampling heap profile is being recorded");
+    return promise->GetHandle();
+  }
+
+  auto* heap_profiler = isolate->GetHeapProfiler();
+  std::unique_ptr<v8::AllocationProfile> profile(
+      heap_profiler->GetAllocationProfile());
+  std::unique_ptr<base::Value> value;
+  if (profile)
+    value = AllocationProfileToValue(isolate, profile.get());
+  heap_profiler->StopSamplingHeapProfiler();
+  sampling_heap_profiling_ = false;
+
+  if (value)
+    ResolveWithProfile(promise, std::move(value));
+  else
+    promise->RejectWithErrorMessage("Failed to record sampling heap profile");
+  return promise->GetHandle();
+}
+
+// static
+void AtomBindings::ResolveWithProfile(scoped_refptr<util::Promise> promise,
+                                      std::unique_ptr<base::Value> profile) {
+  auto resolve = base::BindOnce(
+      [](scoped_refptr<util::Promise> promise, std::string json) {
+        mate::Locker locker(promise->isolate());
+        promise->Resolve(json);
+      },
+      promise);
+
+  // Large profiles take a while to serialize, keep that off this thread when
+  // there is a sequence to reply to.
+  if (base::SequencedTaskRunnerHandle::IsSet()) {
+    base::PostTaskWithTraitsAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&ProfileToJSON, std::move(profile)), std::move(resolve));
+  } else {
+    std::move(resolve).Run(ProfileToJSON(std::move(profile)));
+  }
+}
+
 // static
 void AtomBindings::OnCallNextTick(uv_async_t* handle) {
   AtomBindings* self = static_cast<AtomBindings*>(handle->data);
@@ -339,4 +476,67 @@ bool AtomBindings::TakeHeapSnapshot(v8::Isolate* isolate,
   return atom::TakeHeapSnapshot(isolate, &file);
 }
 
+// static
+v8::Local<v8::Promise> AtomBindings::WriteHeapSnapshot(
+    v8::Isolate* isolate,
+    const base::FilePath& file_path,
+    mate::Arguments* args) {
+  scoped_refptr<util::Promise> promise = new util::Promise(isolate);
+  if (!base::SequencedTaskRunnerHandle::IsSet()) {
+    promise->RejectWithErrorMessage(
+        "writeHeapSnapshot is not supported in this context");
+    return promise->GetHandle();
+  }
+
+  bool gzip = false;
+  HeapSnapshotProgressCallback progress;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("gzip", &gzip);
+    options.Get("onProgress", &progress);
+  }
+
+  base::File file;
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    file.Initialize(file_path,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  }
+  if (!file.IsValid()) {
+    promise->RejectWithErrorMessage("Failed to open " +
+                                    file_path.AsUTF8Unsafe());
+    return promise->GetHandle();
+  }
+
+  v8::Global<v8::Context> context(isolate, isolate->GetCurrentContext());
+  atom::TakeHeapSnapshotAsync(
+      isolate, std::move(file), gzip, progress,
+      base::BindOnce(&AtomBindings::DidWriteHeapSnapshot, std::move(context),
+                     promise));
+  return promise->GetHandle();
+}
+
+// static
+void AtomBindings::DidWriteHeapSnapshot(const v8::Global<v8::Context>& context,
+                                        scoped_refptr<util::Promise> promise,
+                                        bool success,
+                                        int64_t bytes_written) {
+  v8::Isolate* isolate = promise->isolate();
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::MicrotasksScope script_scope(isolate,
+                                   v8::MicrotasksScope::kRunMicrotasks);
+  v8::Context::Scope context_scope(
+      v8::Local<v8::Context>::New(isolate, context));
+
+  if (!success) {
+    promise->RejectWithErrorMessage("Failed to write heap snapshot");
+    return;
+  }
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("bytesWritten", bytes_written);
+  promise->Resolve(dict.GetHandle());
+}
+
 }  // namespace atom
@@ -17,6 +17,10 @@
 #include "uv.h"  // NOLINT(build/include)
 #include "v8/include/v8.h"
 
+namespace base {
+class Value;
+}
+
 namespace mate {
 class Dictionary;
 }
@@ -29,6 +33,10 @@ namespace node {
 class Environment;
 }
 
+namespace v8 {
+class CpuProfiler;
+}
+
 namespace atom {
 
 namespace util {
@@ -66,9 +74,18 @@ class AtomBindings {
   static v8::Local<v8::Value> GetIOCounters(v8::Isolate* isolate);
   static bool TakeHeapSnapshot(v8::Isolate* isolate,
                                const base::FilePath& file_path);
+  static v8::Local<v8::Promise> WriteHeapSnapshot(
+      v8::Isolate* isolate,
+      const base::FilePath& file_path,
+      mate::Arguments* args);
 
   void ActivateUVLoop(v8::Isolate* isolate);
 
+  void StartCpuProfile(mate::Arguments* args);
+  v8::Local<v8::Promise> StopCpuProfile(v8::Isolate* isolate);
+  void StartSamplingHeapProfile(mate::Arguments* args);
+  v8::Local<v8::Promise> StopSamplingHeapProfile(v8::Isolate* isolate);
+
   static void OnCallNextTick(uv_async_t* handle);
 
   static void DidReceiveMemoryDump(
@@ -77,10 +94,23 @@ class AtomBindings {
       bool success,
       std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump);
 
+  static void DidWriteHeapSnapshot(const v8::Global<v8::Context>& context,
+                                   scoped_refptr<util::Promise> promise,
+                                   bool success,
+                                   int64_t bytes_written);
+
+  // Serializes |profile| off the main thread and resolves |promise| with it.
+  static void ResolveWithProfile(scoped_refptr<util::Promise> promise,
+                                 std::unique_ptr<base::Value> profile);
+
   uv_async_t call_next_tick_async_;
   std::list<node::Environment*> pending_next_ticks_;
   std::unique_ptr<base::ProcessMetrics> metrics_;
 
+  // Set while a CPU profile is being recorded.
+  v8::CpuProfiler* cpu_profiler_ = nullptr;
+  bool sampling_heap_profiling_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(AtomBindings);
 };
 
@@ -4,14 +4,52 @@
 
 #include "atom/common/api/remote_callback_freer.h"
 
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "atom/common/api/api_messages.h"
+#include "atom/common/api/remote_release_batcher.h"
+#include "base/bind.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/web_contents.h"
 
 namespace atom {
 
+namespace {
+
+void SendReleaseCallback(const RemoteReleaseBatcher::Key& key,
+                         const std::vector<int>& object_ids) {
+  auto* frame_host =
+      content::RenderFrameHost::FromID(std::get<0>(key), std::get<1>(key));
+  if (!frame_host)
+    return;
+
+  auto* channel = "ELECTRON_RENDERER_RELEASE_CALLBACK";
+  auto ids = std::make_unique<base::ListValue>();
+  for (int object_id : object_ids)
+    ids->AppendInteger(object_id);
+  base::ListValue args;
+  int32_t sender_id = 0;
+  args.AppendString(std::get<2>(key));
+  args.Append(std::move(ids));
+  frame_host->Send(new AtomFrameMsg_Message(frame_host->GetRoutingID(), true,
+                                            false, channel, args, sender_id));
+}
+
+RemoteReleaseBatcher* GetBatcher() {
+  static base::NoDestructor<RemoteReleaseBatcher> batcher(
+      base::BindRepeating(&SendReleaseCallback));
+  return batcher.get();
+}
+
+}  // namespace
+
 // static
 void RemoteCallbackFreer::BindTo(v8::Isolate* isolate,
                                  v8::Local<v8::Object> target,
@@ -29,20 +67,26 @@ RemoteCallbackFreer::RemoteCallbackFreer(v8::Isolate* isolate,
     : ObjectLifeMonitor(isolate, target),
       content::WebContentsObserver(web_contents),
       context_id_(context_id),
-      object_id_(object_id) {}
+      object_id_(object_id) {
+  // The function of a garbage collected callback with the same ID may not
+  // have been released yet, the callback is in use again.
+  auto* frame_host = web_contents->GetMainFrame();
+  if (frame_host) {
+    GetBatcher()->Remove(
+        std::make_tuple(frame_host->GetProcess()->GetID(),
+                        frame_host->GetRoutingID(), context_id_),
+        object_id_);
+  }
+}
 
 RemoteCallbackFreer::~RemoteCallbackFreer() {}
 
 void RemoteCallbackFreer::RunDestructor() {
-  auto* channel = "ELECTRON_RENDERER_RELEASE_CALLBACK";
-  base::ListValue args;
-  int32_t sender_id = 0;
-  args.AppendString(context_id_);
-  args.AppendInteger(object_id_);
   auto* frame_host = web_contents()->GetMainFrame();
   if (frame_host) {
-    frame_host->Send(new AtomFrameMsg_Message(frame_host->GetRoutingID(), true,
-                                              false, channel, args, sender_id));
+    GetBatcher()->Add(std::make_tuple(frame_host->GetProcess()->GetID(),
+                                      frame_host->GetRoutingID(), context_id_),
+                      object_id_);
   }
 
   Observe(nullptr);
@@ -4,7 +4,15 @@
 
 #include "atom/common/api/remote_object_freer.h"
 
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "atom/common/api/api_messages.h"
+#include "atom/common/api/remote_release_batcher.h"
+#include "base/bind.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
@@ -24,6 +32,30 @@ content::RenderFrame* GetCurrentRenderFrame() {
   return content::RenderFrame::FromWebFrame(frame);
 }
 
+void SendDereference(const RemoteReleaseBatcher::Key& key,
+                     const std::vector<int>& object_ids) {
+  content::RenderFrame* render_frame =
+      content::RenderFrame::FromRoutingID(std::get<1>(key));
+  if (!render_frame)
+    return;
+
+  auto* channel = "ELECTRON_BROWSER_DEREFERENCE";
+  auto ids = std::make_unique<base::ListValue>();
+  for (int object_id : object_ids)
+    ids->AppendInteger(object_id);
+  base::ListValue args;
+  args.AppendString(std::get<2>(key));
+  args.Append(std::move(ids));
+  render_frame->Send(new AtomFrameHostMsg_Message(render_frame->GetRoutingID(),
+                                                  true, channel, args, 0));
+}
+
+RemoteReleaseBatcher* GetBatcher() {
+  static base::NoDestructor<RemoteReleaseBatcher> batcher(
+      base::BindRepeating(&SendDereference));
+  return batcher.get();
+}
+
 }  // namespace
 
 // static
@@ -45,23 +77,20 @@ RemoteObjectFreer::RemoteObjectFreer(v8::Isolate* isolate,
   content::RenderFrame* render_frame = GetCurrentRenderFrame();
   if (render_frame) {
     routing_id_ = render_frame->GetRoutingID();
+    // The proxy of a garbage collected object with the same ID may not have
+    // been released yet, the object is in use again.
+    GetBatcher()->Remove(std::make_tuple(0, routing_id_, context_id_),
+                         object_id_);
   }
 }
 
 RemoteObjectFreer::~RemoteObjectFreer() {}
 
 void RemoteObjectFreer::RunDestructor() {
-  content::RenderFrame* render_frame =
-      content::RenderFrame::FromRoutingID(routing_id_);
-  if (!render_frame)
+  if (routing_id_ == MSG_ROUTING_NONE)
     return;
 
-  auto* channel = "ELECTRON_BROWSER_DEREFERENCE";
-  base::ListValue args;
-  args.AppendString(context_id_);
-  args.AppendInteger(object_id_);
-  render_frame->Send(new AtomFrameHostMsg_Message(render_frame->GetRoutingID(),
-                                                  true, channel, args));
+  GetBatcher()->Add(std::make_tuple(0, routing_id_, context_id_), object_id_);
 }
 
 }  // namespace atom
@@ -0,0 +1,62 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/remote_release_batcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
+
+namespace atom {
+
+RemoteReleaseBatcher::RemoteReleaseBatcher(const SendCallback& send)
+    : send_(send) {}
+
+RemoteReleaseBatcher::~RemoteReleaseBatcher() {}
+
+void RemoteReleaseBatcher::Add(const Key& key, int object_id) {
+  pending_[key].push_back(object_id);
+  if (++pending_count_ >= kMaxPendingReleases) {
+    Flush();
+    return;
+  }
+
+  // The batcher is only used as a leaked singleton, so it is safe to post an
+  // unretained task.
+  if (!flush_scheduled_) {
+    flush_scheduled_ = true;
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&RemoteReleaseBatcher::Flush, base::Unretained(this)));
+  }
+}
+
+void RemoteReleaseBatcher::Remove(const Key& key, int object_id) {
+  auto it = pending_.find(key);
+  if (it == pending_.end())
+    return;
+
+  auto& ids = it->second;
+  size_t size = ids.size();
+  ids.erase(std::remove(ids.begin(), ids.end(), object_id), ids.end());
+  pending_count_ -= size - ids.size();
+  if (ids.empty())
+    pending_.erase(it);
+}
+
+void RemoteReleaseBatcher::Flush() {
+  flush_scheduled_ = false;
+  if (pending_.empty())
+    return;
+
+  std::map<Key, std::vector<int>> pending;
+  pending.swap(pending_);
+  pending_count_ = 0;
+  for (const auto& it : pending)
+    send_.Run(it.first, it.second);
+}
+
+}  // namespace atom
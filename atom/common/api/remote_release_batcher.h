@@ -0,0 +1,53 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_REMOTE_RELEASE_BATCHER_H_
+#define ATOM_COMMON_API_REMOTE_RELEASE_BATCHER_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+
+namespace atom {
+
+// Collects the IDs of released remote objects and sends them in batches, so a
+// GC that frees thousands of remote objects results in a single IPC message
+// per frame instead of one message per object.
+//
+// The pending IDs are flushed by a task posted to the current thread, or
+// immediately once |kMaxPendingReleases| IDs have been collected. An ID that
+// is referenced again before then has to be taken back with |Remove|, or the
+// other side would release the object the new reference points to.
+class RemoteReleaseBatcher {
+ public:
+  // (render process ID, frame routing ID, context ID).
+  using Key = std::tuple<int, int, std::string>;
+  using SendCallback =
+      base::RepeatingCallback<void(const Key& key, const std::vector<int>&)>;
+
+  static constexpr size_t kMaxPendingReleases = 512;
+
+  explicit RemoteReleaseBatcher(const SendCallback& send);
+  ~RemoteReleaseBatcher();
+
+  void Add(const Key& key, int object_id);
+  void Remove(const Key& key, int object_id);
+  void Flush();
+
+ private:
+  SendCallback send_;
+  std::map<Key, std::vector<int>> pending_;
+  size_t pending_count_ = 0;
+  bool flush_scheduled_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(RemoteReleaseBatcher);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_REMOTE_RELEASE_BATCHER_H_
@@ -17,6 +17,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 
 #if defined(OS_WIN)
@@ -33,6 +34,9 @@ const char kSeparators[] = "\\/";
 const char kSeparators[] = "/";
 #endif
 
+// Bounds the memory used by the cache of missing paths.
+const size_t kMaxMissingPaths = 4096;
+
 bool GetNodeFromPath(std::string path,
                      const base::DictionaryValue* root,
                      const base::DictionaryValue** out);
@@ -141,6 +145,7 @@ Archive::~Archive() {
 }
 
 bool Archive::Init() {
+  TRACE_EVENT1("electron.asar", "Archive::Init", "path", path_.AsUTF8Unsafe());
   if (!file_.IsValid()) {
     if (file_.error_details() != base::File::FILE_ERROR_NOT_FOUND) {
       LOG(WARNING) << "Opening " << path_.value() << ": "
@@ -200,11 +205,10 @@ bool Archive::Init() {
 }
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
-    return false;
-
+  TRACE_EVENT1("electron.asar", "Archive::GetFileInfo", "path",
+               path.AsUTF8Unsafe());
   const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (!GetNode(path, &node))
     return false;
 
   std::string link;
@@ -215,11 +219,9 @@ bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
-    return false;
-
+  TRACE_EVENT1("electron.asar", "Archive::Stat", "path", path.AsUTF8Unsafe());
   const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (!GetNode(path, &node))
     return false;
 
   if (node->FindKey("link")) {
@@ -239,11 +241,10 @@ bool Archive::Stat(const base::FilePath& path, Stats* stats) {
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
-    return false;
-
+  TRACE_EVENT1("electron.asar", "Archive::Readdir", "path",
+               path.AsUTF8Unsafe());
   const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (!GetNode(path, &node))
     return false;
 
   const base::DictionaryValue* files;
@@ -259,11 +260,8 @@ bool Archive::Readdir(const base::FilePath& path,
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
-    return false;
-
   const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (!GetNode(path, &node))
     return false;
 
   std::string link;
@@ -277,6 +275,8 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  TRACE_EVENT1("electron.asar", "Archive::CopyFileOut", "path",
+               path.AsUTF8Unsafe());
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
@@ -309,8 +309,39 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+bool Archive::ReadFile(const FileInfo& info, std::string* contents) {
+  TRACE_EVENT1("electron.asar", "Archive::ReadFile", "size", info.size);
+  if (info.unpacked)
+    return false;
+
+  contents->resize(info.size);
+  if (info.size == 0)
+    return true;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return file_.Read(info.offset, &(*contents)[0], info.size) ==
+         static_cast<int>(info.size);
+}
+
 int Archive::GetFD() const {
   return fd_;
 }
 
+bool Archive::GetNode(const base::FilePath& path,
+                      const base::DictionaryValue** node) {
+  if (!header_)
+    return false;
+
+  std::string key = path.AsUTF8Unsafe();
+  if (missing_paths_.count(key))
+    return false;
+  if (GetNodeFromPath(key, header_.get(), node))
+    return true;
+
+  if (missing_paths_.size() >= kMaxMissingPaths)
+    missing_paths_.clear();
+  missing_paths_.insert(std::move(key));
+  return false;
+}
+
 }  // namespace asar
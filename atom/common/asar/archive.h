@@ -6,7 +6,9 @@
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "base/files/file.h"
@@ -61,6 +63,9 @@ class Archive {
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Reads the content of a packed file.
+  bool ReadFile(const FileInfo& info, std::string* contents);
+
   // Returns the file's fd.
   int GetFD() const;
 
@@ -68,6 +73,10 @@ class Archive {
   base::DictionaryValue* header() const { return header_.get(); }
 
  private:
+  // Finds the header node of |path|. The paths that do not exist are
+  // remembered, since module resolution probes the same ones repeatedly.
+  bool GetNode(const base::FilePath& path, const base::DictionaryValue** node);
+
   base::FilePath path_;
   base::File file_;
   int fd_ = -1;
@@ -79,6 +88,8 @@ class Archive {
                      std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
 
+  std::unordered_set<std::string> missing_paths_;
+
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
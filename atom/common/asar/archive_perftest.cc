@@ -0,0 +1,141 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/pickle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace asar {
+
+namespace {
+
+const int kFilesPerDirectory = 100;
+const int kInitIterations = 10;
+const int kLookups = 100000;
+
+std::string GetFilePath(int index) {
+  return base::StringPrintf("dir%d/file%d.js", index / kFilesPerDirectory,
+                            index % kFilesPerDirectory);
+}
+
+// Writes an archive with |entries| files spread over directories, the header
+// is laid out the same way the asar tool does.
+bool WriteSyntheticArchive(const base::FilePath& path, int entries) {
+  base::DictionaryValue root;
+  auto* dirs = root.SetDictionary("files",
+                                  std::make_unique<base::DictionaryValue>());
+  for (int i = 0; i < entries; i += kFilesPerDirectory) {
+    auto files = std::make_unique<base::DictionaryValue>();
+    for (int j = i; j < i + kFilesPerDirectory && j < entries; ++j) {
+      auto file = std::make_unique<base::DictionaryValue>();
+      file->SetInteger("size", 1);
+      file->SetString("offset", base::NumberToString(j));
+      files->Set(base::StringPrintf("file%d.js", j % kFilesPerDirectory),
+                 std::move(file));
+    }
+    auto dir = std::make_unique<base::DictionaryValue>();
+    dir->Set("files", std::move(files));
+    dirs->Set(base::StringPrintf("dir%d", i / kFilesPerDirectory),
+              std::move(dir));
+  }
+
+  std::string json;
+  if (!base::JSONWriter::Write(root, &json))
+    return false;
+
+  base::Pickle header;
+  header.WriteString(json);
+  base::Pickle header_size;
+  header_size.WriteUInt32(header.size());
+
+  std::string data(static_cast<const char*>(header_size.data()),
+                   header_size.size());
+  data.append(static_cast<const char*>(header.data()), header.size());
+  data.append(entries, 'x');
+  return base::WriteFile(path, data.data(), data.size()) ==
+         static_cast<int>(data.size());
+}
+
+class ArchivePerfTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath CreateArchive(int entries) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII(
+        base::StringPrintf("%d.asar", entries));
+    EXPECT_TRUE(WriteSyntheticArchive(path, entries));
+    return path;
+  }
+
+  void RunInit(int entries, const std::string& trace) {
+    base::FilePath path = CreateArchive(entries);
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kInitIterations; ++i) {
+      Archive archive(path);
+      ASSERT_TRUE(archive.Init());
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult("asar_archive", "_init", trace,
+                           elapsed.InMillisecondsF() / kInitIterations, "ms",
+                           true);
+  }
+
+  void RunGetFileInfo(int entries, const std::string& trace) {
+    Archive archive(CreateArchive(entries));
+    ASSERT_TRUE(archive.Init());
+
+    // Look the paths up in an order that does not favour any of them.
+    std::vector<base::FilePath> paths;
+    for (int i = 0; i < entries; i += 7)
+      paths.push_back(base::FilePath::FromUTF8Unsafe(GetFilePath(i)));
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kLookups; ++i) {
+      Archive::FileInfo info;
+      ASSERT_TRUE(archive.GetFileInfo(paths[i % paths.size()], &info));
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult("asar_archive", "_get_file_info", trace,
+                           elapsed.InMicrosecondsF() / kLookups, "us", true);
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(ArchivePerfTest, Init10k) {
+  RunInit(10000, "10k_entries");
+}
+
+TEST_F(ArchivePerfTest, Init100k) {
+  RunInit(100000, "100k_entries");
+}
+
+TEST_F(ArchivePerfTest, GetFileInfo10k) {
+  RunGetFileInfo(10000, "10k_entries");
+}
+
+TEST_F(ArchivePerfTest, GetFileInfo100k) {
+  RunGetFileInfo(100000, "100k_entries");
+}
+
+}  // namespace asar
@@ -4,10 +4,37 @@
 
 #include "atom/common/heap_snapshot.h"
 
+#include <string.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
+#include "third_party/zlib/zlib.h"
 #include "v8/include/v8-profiler.h"
 
 namespace {
 
+// Serialized chunks are batched up to this size before being handed to the
+// writer sequence, to keep the number of posted tasks low.
+const size_t kFlushThreshold = 1024 * 1024;
+
+// Bytes that may wait for the writer sequence. Serializing is usually faster
+// than compressing and writing, without a limit the whole snapshot could end
+// up queued in memory. The serializer can not be paused, so the snapshot is
+// aborted when the writer falls this far behind.
+const size_t kMaxPendingBytes = 64 * 1024 * 1024;
+
+// Size of the buffer receiving the compressed output.
+const size_t kDeflateBufferSize = 64 * 1024;
+
 class HeapSnapshotOutputStream : public v8::OutputStream {
  public:
   explicit HeapSnapshotOutputStream(base::File* file) : file_(file) {
@@ -30,6 +57,155 @@ class HeapSnapshotOutputStream : public v8::OutputStream {
   bool is_complete_ = false;
 };
 
+// Compresses and writes the serialized snapshot, lives on a background
+// sequence.
+class HeapSnapshotWriter {
+ public:
+  HeapSnapshotWriter(base::File file,
+                     bool gzip,
+                     scoped_refptr<base::SequencedTaskRunner> reply_runner,
+                     const atom::HeapSnapshotProgressCallback& progress)
+      : file_(std::move(file)),
+        gzip_(gzip),
+        reply_runner_(std::move(reply_runner)),
+        progress_(progress) {
+    if (gzip_) {
+      memset(&zstream_, 0, sizeof(zstream_));
+      // Adding 16 to the window bits produces a gzip header and trailer. The
+      // snapshot JSON compresses well even at the fastest level.
+      if (deflateInit2(&zstream_, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK) {
+        buffer_.resize(kDeflateBufferSize);
+      } else {
+        gzip_ = false;
+        failed_ = true;
+      }
+    }
+  }
+
+  ~HeapSnapshotWriter() {
+    if (gzip_)
+      deflateEnd(&zstream_);
+  }
+
+  // Called on the serializing thread before posting a batch to |Write|,
+  // returns false if the batch would exceed |kMaxPendingBytes|.
+  bool ReservePendingBytes(size_t size) {
+    if (pending_bytes_.load() + size > kMaxPendingBytes)
+      return false;
+    pending_bytes_ += size;
+    return true;
+  }
+
+  void Write(std::string data) {
+    pending_bytes_ -= data.size();
+
+    if (!failed_) {
+      bool success = gzip_ ? Deflate(data.data(), data.size(), Z_NO_FLUSH)
+                           : WriteToFile(data.data(), data.size());
+      if (!success)
+        failed_ = true;
+      else if (!progress_.is_null())
+        reply_runner_->PostTask(FROM_HERE,
+                                base::BindOnce(progress_, bytes_written_));
+    }
+  }
+
+  void Finish(bool complete, atom::HeapSnapshotDoneCallback done) {
+    if (complete && gzip_ && !failed_)
+      failed_ = !Deflate(nullptr, 0, Z_FINISH);
+    file_.Close();
+
+    reply_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(std::move(done), complete && !failed_, bytes_written_));
+  }
+
+ private:
+  bool Deflate(const char* data, size_t size, int flush) {
+    zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zstream_.avail_in = size;
+    do {
+      zstream_.next_out = reinterpret_cast<Bytef*>(buffer_.data());
+      zstream_.avail_out = buffer_.size();
+      if (deflate(&zstream_, flush) == Z_STREAM_ERROR)
+        return false;
+      size_t have = buffer_.size() - zstream_.avail_out;
+      if (have > 0 && !WriteToFile(buffer_.data(), have))
+        return false;
+    } while (zstream_.avail_out == 0);
+    return true;
+  }
+
+  bool WriteToFile(const char* data, size_t size) {
+    TRACE_EVENT1("electron", "HeapSnapshotWriter::WriteToFile", "size", size);
+    if (file_.WriteAtCurrentPos(data, size) != static_cast<int>(size))
+      return false;
+    bytes_written_ += size;
+    return true;
+  }
+
+  base::File file_;
+  bool gzip_;
+  scoped_refptr<base::SequencedTaskRunner> reply_runner_;
+  atom::HeapSnapshotProgressCallback progress_;
+
+  z_stream zstream_;
+  std::vector<char> buffer_;
+
+  bool failed_ = false;
+  int64_t bytes_written_ = 0;
+
+  // Bytes posted to |Write| but not written yet, the only state shared with
+  // the serializing thread.
+  std::atomic<size_t> pending_bytes_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotWriter);
+};
+
+// Collects the serialized chunks and hands them to the HeapSnapshotWriter.
+class AsyncHeapSnapshotOutputStream : public v8::OutputStream {
+ public:
+  AsyncHeapSnapshotOutputStream(
+      scoped_refptr<base::SequencedTaskRunner> task_runner,
+      HeapSnapshotWriter* writer)
+      : task_runner_(std::move(task_runner)), writer_(writer) {}
+
+  bool IsComplete() const { return is_complete_; }
+
+  // v8::OutputStream
+  int GetChunkSize() override { return 65536; }
+
+  void EndOfStream() override { is_complete_ = Flush(); }
+
+  v8::OutputStream::WriteResult WriteAsciiChunk(char* data, int size) override {
+    buffer_.append(data, size);
+    if (buffer_.size() >= kFlushThreshold && !Flush())
+      return kAbort;
+    return kContinue;
+  }
+
+ private:
+  bool Flush() {
+    if (buffer_.empty())
+      return true;
+    if (!writer_->ReservePendingBytes(buffer_.size()))
+      return false;
+    // The writer is deleted on |task_runner_| after all the posted writes.
+    task_runner_->PostTask(FROM_HERE,
+                           base::BindOnce(&HeapSnapshotWriter::Write,
+                                          base::Unretained(writer_),
+                                          std::move(buffer_)));
+    buffer_.clear();
+    return true;
+  }
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  HeapSnapshotWriter* writer_;
+  std::string buffer_;
+  bool is_complete_ = false;
+};
+
 }  // namespace
 
 namespace atom {
@@ -53,4 +229,42 @@ bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file) {
   return stream.IsComplete();
 }
 
+void TakeHeapSnapshotAsync(v8::Isolate* isolate,
+                           base::File file,
+                           bool gzip,
+                           const HeapSnapshotProgressCallback& progress,
+                           HeapSnapshotDoneCallback done) {
+  DCHECK(isolate);
+  TRACE_EVENT0("electron", "TakeHeapSnapshotAsync");
+
+  auto reply_runner = base::SequencedTaskRunnerHandle::Get();
+  if (!file.IsValid()) {
+    reply_runner->PostTask(FROM_HERE,
+                           base::BindOnce(std::move(done), false, 0));
+    return;
+  }
+
+  // Blocks shutdown so the file is always finished and closed, the reply is
+  // dropped if the calling sequence is gone by then.
+  auto task_runner = base::CreateSequencedTaskRunnerWithTraits(
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::BLOCK_SHUTDOWN});
+  std::unique_ptr<HeapSnapshotWriter, base::OnTaskRunnerDeleter> writer(
+      new HeapSnapshotWriter(std::move(file), gzip, reply_runner, progress),
+      base::OnTaskRunnerDeleter(task_runner));
+
+  bool complete = false;
+  auto* snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
+  if (snapshot) {
+    AsyncHeapSnapshotOutputStream stream(task_runner, writer.get());
+    snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+    const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+    complete = stream.IsComplete();
+  }
+
+  task_runner->PostTask(FROM_HERE, base::BindOnce(&HeapSnapshotWriter::Finish,
+                                                 base::Unretained(writer.get()),
+                                                 complete, std::move(done)));
+}
+
 }  // namespace atom
@@ -5,6 +5,9 @@
 #ifndef ATOM_COMMON_HEAP_SNAPSHOT_H_
 #define ATOM_COMMON_HEAP_SNAPSHOT_H_
 
+#include <stdint.h>
+
+#include "base/callback.h"
 #include "base/files/file.h"
 #include "v8/include/v8.h"
 
@@ -12,6 +15,21 @@ namespace atom {
 
 bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file);
 
+// Called with the number of bytes written to the file so far.
+using HeapSnapshotProgressCallback =
+    base::RepeatingCallback<void(int64_t bytes_written)>;
+using HeapSnapshotDoneCallback =
+    base::OnceCallback<void(bool success, int64_t bytes_written)>;
+
+// Takes a heap snapshot on the calling thread, but hands the serialized chunks
+// to a background sequence which compresses them when |gzip| is set and writes
+// them to |file|. The callbacks are run on the calling sequence.
+void TakeHeapSnapshotAsync(v8::Isolate* isolate,
+                           base::File file,
+                           bool gzip,
+                           const HeapSnapshotProgressCallback& progress,
+                           HeapSnapshotDoneCallback done);
+
 }  // namespace atom
 
 #endif  // ATOM_COMMON_HEAP_SNAPSHOT_H_
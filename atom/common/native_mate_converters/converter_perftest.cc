@@ -0,0 +1,145 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "gin/test/v8_test.h"
+#include "native_mate/converter.h"
+#include "testing/perf/perf_test.h"
+
+namespace atom {
+
+namespace {
+
+const int kIterations = 10;
+
+// Builds a tree of dictionaries |depth| levels deep with |breadth| children
+// per level, the leaves being a mix of strings, numbers and short lists.
+std::unique_ptr<base::Value> CreateNestedValue(int depth, int breadth) {
+  auto dict = std::make_unique<base::DictionaryValue>();
+  for (int i = 0; i < breadth; ++i) {
+    std::string key = "key" + base::NumberToString(i);
+    if (depth > 1) {
+      dict->Set(key, CreateNestedValue(depth - 1, breadth));
+    } else if (i % 3 == 0) {
+      dict->SetString(key, "value" + base::NumberToString(i));
+    } else if (i % 3 == 1) {
+      dict->SetDouble(key, i + 0.5);
+    } else {
+      auto list = std::make_unique<base::ListValue>();
+      for (int j = 0; j < 4; ++j)
+        list->AppendInteger(j);
+      dict->Set(key, std::move(list));
+    }
+  }
+  return dict;
+}
+
+std::unique_ptr<base::Value> CreateLargeList(int size) {
+  auto list = std::make_unique<base::ListValue>();
+  for (int i = 0; i < size; ++i) {
+    if (i % 2)
+      list->AppendInteger(i);
+    else
+      list->AppendString(base::NumberToString(i));
+  }
+  return list;
+}
+
+class ConverterPerfTest : public gin::V8Test {
+ protected:
+  void RunRoundTrip(const base::Value& value, const std::string& trace) {
+    v8::Isolate* isolate = instance_->isolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context =
+        v8::Local<v8::Context>::New(isolate, context_);
+
+    V8ValueConverter converter;
+    base::TimeDelta to_v8;
+    base::TimeDelta from_v8;
+    for (int i = 0; i < kIterations; ++i) {
+      v8::HandleScope iteration_scope(isolate);
+
+      base::TimeTicks start = base::TimeTicks::Now();
+      v8::Local<v8::Value> v8_value = converter.ToV8Value(&value, context);
+      to_v8 += base::TimeTicks::Now() - start;
+
+      start = base::TimeTicks::Now();
+      std::unique_ptr<base::Value> result =
+          converter.FromV8Value(v8_value, context);
+      from_v8 += base::TimeTicks::Now() - start;
+
+      ASSERT_TRUE(result);
+      ASSERT_EQ(value, *result);
+    }
+
+    perf_test::PrintResult("v8_value_converter", "_to_v8", trace,
+                           to_v8.InMillisecondsF() / kIterations, "ms", true);
+    perf_test::PrintResult("v8_value_converter", "_from_v8", trace,
+                           from_v8.InMillisecondsF() / kIterations, "ms", true);
+  }
+
+  template <typename T>
+  void RunVectorRoundTrip(const std::vector<T>& vector,
+                          const std::string& trace) {
+    v8::Isolate* isolate = instance_->isolate();
+    v8::HandleScope handle_scope(isolate);
+
+    base::TimeDelta to_v8;
+    base::TimeDelta from_v8;
+    for (int i = 0; i < kIterations; ++i) {
+      v8::HandleScope iteration_scope(isolate);
+
+      base::TimeTicks start = base::TimeTicks::Now();
+      v8::Local<v8::Value> v8_value = mate::ConvertToV8(isolate, vector);
+      to_v8 += base::TimeTicks::Now() - start;
+
+      start = base::TimeTicks::Now();
+      std::vector<T> result;
+      ASSERT_TRUE(mate::ConvertFromV8(isolate, v8_value, &result));
+      from_v8 += base::TimeTicks::Now() - start;
+
+      ASSERT_EQ(vector.size(), result.size());
+    }
+
+    perf_test::PrintResult("mate_vector_converter", "_to_v8", trace,
+                           to_v8.InMillisecondsF() / kIterations, "ms", true);
+    perf_test::PrintResult("mate_vector_converter", "_from_v8", trace,
+                           from_v8.InMillisecondsF() / kIterations, "ms", true);
+  }
+};
+
+}  // namespace
+
+TEST_F(ConverterPerfTest, NestedObject) {
+  // 8^4 leaves.
+  RunRoundTrip(*CreateNestedValue(4, 8), "nested_object");
+}
+
+TEST_F(ConverterPerfTest, LargeArray) {
+  RunRoundTrip(*CreateLargeList(100000), "large_array");
+}
+
+TEST_F(ConverterPerfTest, VectorOfInts) {
+  std::vector<int> vector(100000);
+  for (size_t i = 0; i < vector.size(); ++i)
+    vector[i] = i;
+  RunVectorRoundTrip(vector, "100k_ints");
+}
+
+TEST_F(ConverterPerfTest, VectorOfStrings) {
+  std::vector<std::string> vector(100000);
+  for (size_t i = 0; i < vector.size(); ++i)
+    vector[i] = "string" + base::NumberToString(i);
+  RunVectorRoundTrip(vector, "100k_strings");
+}
+
+}  // namespace atom
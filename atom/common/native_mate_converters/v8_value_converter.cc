@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "base/logging.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "native_mate/dictionary.h"
 
@@ -23,6 +24,24 @@ namespace {
 
 const int kMaxRecursionDepth = 100;
 
+// Number of top level elements in |value|, reported by the trace events.
+size_t GetTopLevelSize(const base::Value* value) {
+  if (!value)
+    return 0;
+  switch (value->type()) {
+    case base::Value::Type::LIST:
+      return value->GetList().size();
+    case base::Value::Type::DICTIONARY:
+      return value->DictSize();
+    case base::Value::Type::BINARY:
+      return value->GetBlob().size();
+    case base::Value::Type::STRING:
+      return value->GetString().size();
+    default:
+      return 1;
+  }
+}
+
 }  // namespace
 
 // The state of a call to FromV8Value.
@@ -141,6 +160,8 @@ void V8ValueConverter::SetStripNullFromObjects(bool val) {
 v8::Local<v8::Value> V8ValueConverter::ToV8Value(
     const base::Value* value,
     v8::Local<v8::Context> context) const {
+  TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("electron.converters"),
+               "V8ValueConverter::ToV8Value", "size", GetTopLevelSize(value));
   v8::Context::Scope context_scope(context);
   v8::EscapableHandleScope handle_scope(context->GetIsolate());
   return handle_scope.Escape(ToV8ValueImpl(context->GetIsolate(), value));
@@ -152,7 +173,13 @@ std::unique_ptr<base::Value> V8ValueConverter::FromV8Value(
   v8::Context::Scope context_scope(context);
   v8::HandleScope handle_scope(context->GetIsolate());
   FromV8ValueState state;
-  return FromV8ValueImpl(&state, val, context->GetIsolate());
+  TRACE_EVENT_BEGIN0(TRACE_DISABLED_BY_DEFAULT("electron.converters"),
+                     "V8ValueConverter::FromV8Value");
+  auto result = FromV8ValueImpl(&state, val, context->GetIsolate());
+  TRACE_EVENT_END1(TRACE_DISABLED_BY_DEFAULT("electron.converters"),
+                   "V8ValueConverter::FromV8Value", "size",
+                   GetTopLevelSize(result.get()));
+  return result;
 }
 
 v8::Local<v8::Value> V8ValueConverter::ToV8ValueImpl(
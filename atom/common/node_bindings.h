@@ -67,8 +67,12 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Whether uv events are polled in the embed thread, otherwise the derived
+  // class is responsible for running the uv loop when it has events.
+  virtual bool UsesEmbedThread() const;
+
   // Run the libuv loop for once.
-  void UvRunOnce();
+  virtual void UvRunOnce();
 
   // Make the main thread run libuv loop.
   void WakeupMainThread();
@@ -92,6 +96,9 @@ class NodeBindings {
   // Whether the libuv loop has ended.
   bool embed_closed_ = false;
 
+  // Whether the embed thread has been started.
+  bool embed_thread_started_ = false;
+
   // Loop used when constructed in WORKER mode
   uv_loop_t worker_loop_;
 
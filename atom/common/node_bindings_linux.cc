@@ -6,18 +6,31 @@
 
 #include <sys/epoll.h>
 
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+
 namespace atom {
 
 NodeBindingsLinux::NodeBindingsLinux(BrowserEnvironment browser_env)
-    : NodeBindings(browser_env), epoll_(epoll_create(1)) {
+    : NodeBindings(browser_env), epoll_(epoll_create(1)), weak_factory_(this) {
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = {0};
   ev.events = EPOLLIN;
   ev.data.fd = backend_fd;
   epoll_ctl(epoll_, EPOLL_CTL_ADD, backend_fd, &ev);
+
+  // Only the browser process runs a glib main loop on its main thread.
+  watch_in_main_loop_ =
+      browser_env == BROWSER &&
+      !base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kNodeEmbedThread);
 }
 
-NodeBindingsLinux::~NodeBindingsLinux() {}
+NodeBindingsLinux::~NodeBindingsLinux() {
+  if (backend_fd_source_)
+    g_source_remove(backend_fd_source_);
+}
 
 void NodeBindingsLinux::RunMessageLoop() {
   // Get notified when libuv's watcher queue changes.
@@ -31,11 +44,32 @@ void NodeBindingsLinux::RunMessageLoop() {
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // New watchers are only added to the backend fd when the loop runs, so run
+  // it again.
+  if (self->watch_in_main_loop_) {
+    self->ScheduleUvRunOnce();
+    return;
+  }
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
 }
 
+// static
+gboolean NodeBindingsLinux::OnBackendFdReadable(GIOChannel* channel,
+                                                GIOCondition condition,
+                                                gpointer data) {
+  NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(data);
+
+  // The fd stays readable until the loop runs, so stop watching it until
+  // then to not spin the glib loop. Running the loop from a posted task rather
+  // than from here keeps it running in nested run loops.
+  self->backend_fd_source_ = 0;
+  self->ScheduleUvRunOnce();
+  return G_SOURCE_REMOVE;
+}
+
 void NodeBindingsLinux::PollEvents() {
   int timeout = uv_backend_timeout(uv_loop_);
 
@@ -47,6 +81,45 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::UsesEmbedThread() const {
+  return !watch_in_main_loop_;
+}
+
+void NodeBindingsLinux::UvRunOnce() {
+  uv_run_scheduled_ = false;
+  NodeBindings::UvRunOnce();
+  if (watch_in_main_loop_)
+    WatchUvLoop();
+}
+
+void NodeBindingsLinux::ScheduleUvRunOnce() {
+  if (uv_run_scheduled_)
+    return;
+  uv_run_scheduled_ = true;
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&NodeBindingsLinux::UvRunOnce,
+                                        weak_factory_.GetWeakPtr()));
+}
+
+void NodeBindingsLinux::WatchUvLoop() {
+  if (!backend_fd_source_) {
+    GIOChannel* channel = g_io_channel_unix_new(uv_backend_fd(uv_loop_));
+    backend_fd_source_ =
+        g_io_add_watch(channel, G_IO_IN, OnBackendFdReadable, this);
+    g_io_channel_unref(channel);
+  }
+
+  // Fold uv's next timer into the delayed work of the message loop.
+  int timeout = uv_backend_timeout(uv_loop_);
+  if (timeout < 0) {
+    uv_timer_.Stop();
+  } else {
+    uv_timer_.Start(FROM_HERE, base::TimeDelta::FromMilliseconds(timeout),
+                    base::BindOnce(&NodeBindingsLinux::UvRunOnce,
+                                   base::Unretained(this)));
+  }
+}
+
 // static
 NodeBindings* NodeBindings::Create(BrowserEnvironment browser_env) {
   return new NodeBindingsLinux(browser_env);
@@ -5,8 +5,12 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_LINUX_H_
 #define ATOM_COMMON_NODE_BINDINGS_LINUX_H_
 
+#include <glib.h>
+
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 
 namespace atom {
 
@@ -21,11 +25,38 @@ class NodeBindingsLinux : public NodeBindings {
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
+  // Called by glib when uv's backend fd becomes readable.
+  static gboolean OnBackendFdReadable(GIOChannel* channel,
+                                      GIOCondition condition,
+                                      gpointer data);
+
   void PollEvents() override;
+  bool UsesEmbedThread() const override;
+  void UvRunOnce() override;
+
+  // Posts a task to run the uv loop, unless one is already pending.
+  void ScheduleUvRunOnce();
+
+  // Watches uv's backend fd and next timer from the main loop.
+  void WatchUvLoop();
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // Whether the uv loop is watched from the glib main loop of the main thread
+  // instead of the embed thread.
+  bool watch_in_main_loop_ = false;
+
+  // The glib source watching uv's backend fd, 0 when not watching.
+  guint backend_fd_source_ = 0;
+
+  bool uv_run_scheduled_ = false;
+
+  // Runs the uv loop when its next timer is due.
+  base::OneShotTimer uv_timer_;
+
+  base::WeakPtrFactory<NodeBindingsLinux> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
@@ -220,6 +220,11 @@ const char kNodeIntegrationInWorker[] = "node-integration-in-worker";
 // environments will be created in sub-frames.
 const char kNodeIntegrationInSubFrames[] = "node-integration-in-subframes";
 
+// Command switches passed to renderer process to persist the code compiled for
+// the scripts required by pages of the listed schemes in the given directory.
+const char kCodeCacheSchemes[] = "code-cache-schemes";
+const char kCodeCachePath[] = "code-cache-path";
+
 // Widevine options
 // Path to Widevine CDM binaries.
 const char kWidevineCdmPath[] = "widevine-cdm-path";
@@ -239,6 +244,25 @@ const char kAuthServerWhitelist[] = "auth-server-whitelist";
 const char kAuthNegotiateDelegateWhitelist[] =
     "auth-negotiate-delegate-whitelist";
 
+// Polls node's event loop in a separate thread on Linux, instead of watching
+// it from the main loop of the browser process.
+const char kNodeEmbedThread[] = "node-embed-thread";
+
+// How long the main process's message loop must be quiet before V8 is given
+// idle time to collect garbage, in milliseconds.
+const char kGCIdleDelay[] = "gc-idle-delay";
+
+// How long V8 may collect garbage per idle period, in milliseconds.
+const char kGCIdleTime[] = "gc-idle-time";
+
+// How much the main process's heap must grow after a garbage collection before
+// the next one is scheduled, in megabytes.
+const char kGCMinHeapGrowth[] = "gc-min-heap-growth";
+
+// Takes the single instance lock before the browser is initialized, so a second
+// instance hands its command line over and exits without starting Chromium.
+const char kEarlySingleInstance[] = "early-single-instance";
+
 }  // namespace switches
 
 }  // namespace atom
@@ -111,6 +111,8 @@ extern const char kNativeWindowOpen[];
 extern const char kNodeIntegrationInWorker[];
 extern const char kWebviewTag[];
 extern const char kNodeIntegrationInSubFrames[];
+extern const char kCodeCacheSchemes[];
+extern const char kCodeCachePath[];
 
 extern const char kWidevineCdmPath[];
 extern const char kWidevineCdmVersion[];
@@ -119,6 +121,11 @@ extern const char kDiskCacheSize[];
 extern const char kIgnoreConnectionsLimit[];
 extern const char kAuthServerWhitelist[];
 extern const char kAuthNegotiateDelegateWhitelist[];
+extern const char kNodeEmbedThread[];
+extern const char kGCIdleDelay[];
+extern const char kGCIdleTime[];
+extern const char kGCMinHeapGrowth[];
+extern const char kEarlySingleInstance[];
 
 }  // namespace switches
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/profile_util.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace atom {
+
+namespace {
+
+std::string ToUTF8(v8::Isolate* isolate, v8::Local<v8::String> str) {
+  if (str.IsEmpty())
+    return std::string();
+  v8::String::Utf8Value utf8(isolate, str);
+  return std::string(*utf8, utf8.length());
+}
+
+base::Value CallFrameToValue(const char* function_name,
+                             int script_id,
+                             const char* url,
+                             int line_number,
+                             int column_number) {
+  base::Value frame(base::Value::Type::DICTIONARY);
+  frame.SetKey("functionName", base::Value(function_name ? function_name : ""));
+  frame.SetKey("scriptId", base::Value(base::NumberToString(script_id)));
+  frame.SetKey("url", base::Value(url ? url : ""));
+  // V8 counts lines and columns from 1, while DevTools counts them from 0.
+  frame.SetKey("lineNumber", base::Value(line_number - 1));
+  frame.SetKey("columnNumber", base::Value(column_number - 1));
+  return frame;
+}
+
+base::Value AllocationNodeToValue(v8::Isolate* isolate,
+                                  const v8::AllocationProfile::Node* node) {
+  double self_size = 0;
+  for (const auto& allocation : node->allocations)
+    self_size += static_cast<double>(allocation.size) * allocation.count;
+
+  base::Value::ListStorage children;
+  children.reserve(node->children.size());
+  for (const auto* child : node->children)
+    children.push_back(AllocationNodeToValue(isolate, child));
+
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetKey("callFrame",
+               CallFrameToValue(ToUTF8(isolate, node->name).c_str(),
+                                node->script_id,
+                                ToUTF8(isolate, node->script_name).c_str(),
+                                node->line_number, node->column_number));
+  value.SetKey("selfSize", base::Value(self_size));
+  value.SetKey("id", base::Value(static_cast<int>(node->node_id)));
+  value.SetKey("children", base::Value(std::move(children)));
+  return value;
+}
+
+}  // namespace
+
+std::unique_ptr<base::Value> CpuProfileToValue(const v8::CpuProfile* profile) {
+  // Nodes are listed flat and reference their children by id, walk the tree
+  // with an explicit stack since it can be as deep as the deepest JS stack.
+  base::Value::ListStorage nodes;
+  std::vector<const v8::CpuProfileNode*> pending = {profile->GetTopDownRoot()};
+  while (!pending.empty()) {
+    const v8::CpuProfileNode* node = pending.back();
+    pending.pop_back();
+
+    base::Value::ListStorage children;
+    children.reserve(node->GetChildrenCount());
+    for (int i = 0; i < node->GetChildrenCount(); ++i) {
+      const v8::CpuProfileNode* child = node->GetChild(i);
+      children.emplace_back(static_cast<int>(child->GetNodeId()));
+      pending.push_back(child);
+    }
+
+    base::Value value(base::Value::Type::DICTIONARY);
+    value.SetKey("id", base::Value(static_cast<int>(node->GetNodeId())));
+    value.SetKey("callFrame",
+                 CallFrameToValue(node->GetFunctionNameStr(),
+                                  node->GetScriptId(),
+                                  node->GetScriptResourceNameStr(),
+                                  node->GetLineNumber(),
+                                  node->GetColumnNumber()));
+    value.SetKey("hitCount",
+                 base::Value(static_cast<int>(node->GetHitCount())));
+    value.SetKey("children", base::Value(std::move(children)));
+    nodes.push_back(std::move(value));
+  }
+
+  base::Value::ListStorage samples;
+  base::Value::ListStorage time_deltas;
+  samples.reserve(profile->GetSamplesCount());
+  time_deltas.reserve(profile->GetSamplesCount());
+  int64_t last_timestamp = profile->GetStartTime();
+  for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+    samples.emplace_back(static_cast<int>(profile->GetSample(i)->GetNodeId()));
+    int64_t timestamp = profile->GetSampleTimestamp(i);
+    time_deltas.emplace_back(static_cast<int>(timestamp - last_timestamp));
+    last_timestamp = timestamp;
+  }
+
+  auto result = std::make_unique<base::Value>(base::Value::Type::DICTIONARY);
+  result->SetKey("nodes", base::Value(std::move(nodes)));
+  result->SetKey("startTime",
+                 base::Value(static_cast<double>(profile->GetStartTime())));
+  result->SetKey("endTime",
+                 base::Value(static_cast<double>(profile->GetEndTime())));
+  result->SetKey("samples", base::Value(std::move(samples)));
+  result->SetKey("timeDeltas", base::Value(std::move(time_deltas)));
+  return result;
+}
+
+std::unique_ptr<base::Value> AllocationProfileToValue(
+    v8::Isolate* isolate,
+    v8::AllocationProfile* profile) {
+  base::Value::ListStorage samples;
+  samples.reserve(profile->GetSamples().size());
+  for (const auto& sample : profile->GetSamples()) {
+    base::Value value(base::Value::Type::DICTIONARY);
+    value.SetKey("size", base::Value(static_cast<double>(sample.size) *
+                                     sample.count));
+    value.SetKey("nodeId", base::Value(static_cast<int>(sample.node_id)));
+    value.SetKey("ordinal", base::Value(static_cast<double>(sample.sample_id)));
+    samples.push_back(std::move(value));
+  }
+
+  auto result = std::make_unique<base::Value>(base::Value::Type::DICTIONARY);
+  result->SetKey("head",
+                 AllocationNodeToValue(isolate, profile->GetRootNode()));
+  result->SetKey("samples", base::Value(std::move(samples)));
+  return result;
+}
+
+std::string ProfileToJSON(std::unique_ptr<base::Value> profile) {
+  std::string json;
+  base::JSONWriter::Write(*profile, &json);
+  return json;
+}
+
+}  // namespace atom
@@ -0,0 +1,29 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_PROFILE_UTIL_H_
+#define ATOM_COMMON_PROFILE_UTIL_H_
+
+#include <memory>
+#include <string>
+
+#include "base/values.h"
+#include "v8/include/v8-profiler.h"
+
+namespace atom {
+
+// Convert a CPU profile to the .cpuprofile format used by DevTools.
+std::unique_ptr<base::Value> CpuProfileToValue(const v8::CpuProfile* profile);
+
+// Convert a sampling heap profile to the .heapprofile format used by DevTools.
+std::unique_ptr<base::Value> AllocationProfileToValue(
+    v8::Isolate* isolate,
+    v8::AllocationProfile* profile);
+
+// Serialize a converted profile, this can be done on any thread.
+std::string ProfileToJSON(std::unique_ptr<base::Value> profile);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_PROFILE_UTIL_H_
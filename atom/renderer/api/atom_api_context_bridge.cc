@@ -0,0 +1,454 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "gin/converter.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+#include "third_party/blink/public/web/web_local_frame.h"
+
+#include "atom/common/node_includes.h"
+
+namespace {
+
+// Deeper values are most likely a mistake and would overflow the stack.
+const int kMaxRecursion = 1000;
+
+// Remembers the objects already passed during one trip over the bridge, so
+// values that are referenced twice, or refer to themselves, keep their shape.
+class ObjectCache {
+ public:
+  bool Get(v8::Local<v8::Object> source, v8::Local<v8::Value>* result) const {
+    auto range = cache_.equal_range(source->GetIdentityHash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.first == source) {
+        *result = it->second.second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Set(v8::Local<v8::Object> source, v8::Local<v8::Value> result) {
+    cache_.emplace(source->GetIdentityHash(), std::make_pair(source, result));
+  }
+
+ private:
+  std::unordered_multimap<
+      int,
+      std::pair<v8::Local<v8::Object>, v8::Local<v8::Value>>>
+      cache_;
+};
+
+v8::MaybeLocal<v8::Value> PassValueToOtherContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Value> value,
+    ObjectCache* cache,
+    int depth,
+    std::string* error);
+
+// Errors are passed by message, their stack would leak the other world's
+// source.
+v8::Local<v8::Value> PassErrorToOtherContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Value> exception) {
+  v8::Isolate* isolate = destination->GetIsolate();
+  if (!exception->IsNativeError()) {
+    // The getters of the thrown value may throw too, their exception is
+    // replaced by the generic error below.
+    v8::TryCatch try_catch(isolate);
+    ObjectCache cache;
+    std::string error;
+    v8::Local<v8::Value> result;
+    if (PassValueToOtherContext(source, destination, exception, &cache, 0,
+                                &error)
+            .ToLocal(&result))
+      return result;
+  }
+
+  std::string message = "An unknown exception occurred";
+  if (exception->IsNativeError()) {
+    v8::Context::Scope source_scope(source);
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Value> value;
+    v8::Local<v8::String> str;
+    if (exception.As<v8::Object>()
+            ->Get(source, mate::StringToV8(isolate, "message"))
+            .ToLocal(&value) &&
+        value->ToString(source).ToLocal(&str))
+      message = gin::V8ToString(isolate, str);
+  }
+
+  v8::Context::Scope destination_scope(destination);
+  return v8::Exception::Error(mate::StringToV8(isolate, message));
+}
+
+// Passes |value| to a caller in |destination|. Reading the value runs the
+// getters of |source|, an exception they throw must not reach the caller as
+// it is, or its constructor would hand out the Function of the other world.
+// On failure |exception| is an error of |destination|, or empty when the
+// isolate is terminating.
+v8::MaybeLocal<v8::Value> PassValueToCallerContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Value> value,
+    v8::Local<v8::Value>* exception) {
+  v8::Isolate* isolate = destination->GetIsolate();
+  ObjectCache cache;
+  std::string error;
+  {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Value> result;
+    if (PassValueToOtherContext(source, destination, value, &cache, 0, &error)
+            .ToLocal(&result))
+      return result;
+    if (try_catch.HasCaught()) {
+      if (try_catch.CanContinue())
+        *exception =
+            PassErrorToOtherContext(source, destination, try_catch.Exception());
+      return v8::MaybeLocal<v8::Value>();
+    }
+  }
+
+  v8::Context::Scope destination_scope(destination);
+  *exception = v8::Exception::TypeError(mate::StringToV8(
+      isolate, error.empty() ? "An unknown exception occurred" : error));
+  return v8::MaybeLocal<v8::Value>();
+}
+
+// Runs a function of the other world with the arguments passed from the
+// calling world, and passes the result back.
+void ProxyFunctionWrapper(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Function> func = info.Data().As<v8::Function>();
+  v8::Local<v8::Context> calling_context = isolate->GetCurrentContext();
+  v8::Local<v8::Context> func_context = func->CreationContext();
+
+  ObjectCache cache;
+  std::string error;
+  std::vector<v8::Local<v8::Value>> args;
+  args.reserve(info.Length());
+  for (int i = 0; i < info.Length(); ++i) {
+    v8::Local<v8::Value> arg;
+    if (!PassValueToOtherContext(calling_context, func_context, info[i],
+                                 &cache, 0, &error)
+             .ToLocal(&arg)) {
+      if (!error.empty())
+        isolate->ThrowException(
+            v8::Exception::TypeError(mate::StringToV8(isolate, error)));
+      return;
+    }
+    args.push_back(arg);
+  }
+
+  v8::Local<v8::Value> result;
+  v8::Local<v8::Value> exception;
+  {
+    v8::Context::Scope func_scope(func_context);
+    v8::TryCatch try_catch(isolate);
+    if (!func->Call(func_context, v8::Undefined(isolate), args.size(),
+                    args.data())
+             .ToLocal(&result)) {
+      if (!try_catch.CanContinue())
+        return;
+      exception = try_catch.Exception();
+    }
+  }
+
+  if (!exception.IsEmpty()) {
+    isolate->ThrowException(
+        PassErrorToOtherContext(func_context, calling_context, exception));
+    return;
+  }
+
+  if (!PassValueToCallerContext(func_context, calling_context, result,
+                                &exception)
+           .ToLocal(&result)) {
+    if (!exception.IsEmpty())
+      isolate->ThrowException(exception);
+    return;
+  }
+  info.GetReturnValue().Set(result);
+}
+
+// Settles the promise of the other world, the resolver is the data of the
+// function.
+void SettlePromise(const v8::FunctionCallbackInfo<v8::Value>& info,
+                   bool resolve) {
+  v8::Isolate* isolate = info.GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  auto resolver = info.Data().As<v8::Promise::Resolver>();
+  v8::Local<v8::Context> source = isolate->GetCurrentContext();
+  v8::Local<v8::Context> destination =
+      resolver->GetPromise()->CreationContext();
+
+  v8::Local<v8::Value> value;
+  if (resolve) {
+    v8::Local<v8::Value> exception;
+    if (!PassValueToCallerContext(source, destination, info[0], &exception)
+             .ToLocal(&value)) {
+      if (exception.IsEmpty())
+        return;
+      resolve = false;
+      value = exception;
+    }
+  } else {
+    value = PassErrorToOtherContext(source, destination, info[0]);
+  }
+
+  v8::Context::Scope destination_scope(destination);
+  if (resolve)
+    ignore_result(resolver->Resolve(destination, value));
+  else
+    ignore_result(resolver->Reject(destination, value));
+}
+
+void ResolvePromise(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  SettlePromise(info, true);
+}
+
+void RejectPromise(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  SettlePromise(info, false);
+}
+
+v8::MaybeLocal<v8::Value> PassPromiseToOtherContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Promise> promise) {
+  v8::Local<v8::Promise::Resolver> resolver;
+  {
+    v8::Context::Scope destination_scope(destination);
+    if (!v8::Promise::Resolver::New(destination).ToLocal(&resolver))
+      return v8::MaybeLocal<v8::Value>();
+  }
+
+  v8::Context::Scope source_scope(source);
+  v8::Local<v8::Function> on_resolve;
+  v8::Local<v8::Function> on_reject;
+  if (!v8::Function::New(source, ResolvePromise, resolver)
+           .ToLocal(&on_resolve) ||
+      !v8::Function::New(source, RejectPromise, resolver).ToLocal(&on_reject) ||
+      promise->Then(source, on_resolve, on_reject).IsEmpty())
+    return v8::MaybeLocal<v8::Value>();
+  return resolver->GetPromise();
+}
+
+// Copies the bytes of the view into a new buffer of the destination world.
+// V8 can not share a backing store between two ArrayBuffers yet, so this is a
+// single memcpy rather than a structured clone.
+v8::MaybeLocal<v8::Value> PassArrayBufferViewToOtherContext(
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::ArrayBufferView> view) {
+  v8::Isolate* isolate = destination->GetIsolate();
+  v8::Context::Scope destination_scope(destination);
+  size_t length = view->ByteLength();
+  auto buffer = v8::ArrayBuffer::New(isolate, length);
+  view->CopyContents(buffer->GetContents().Data(), length);
+
+#define TYPED_ARRAY(Type, size)                  \
+  if (view->Is##Type())                          \
+    return v8::Type::New(buffer, 0, length / size);
+  TYPED_ARRAY(Uint8Array, 1)
+  TYPED_ARRAY(Uint8ClampedArray, 1)
+  TYPED_ARRAY(Int8Array, 1)
+  TYPED_ARRAY(Uint16Array, 2)
+  TYPED_ARRAY(Int16Array, 2)
+  TYPED_ARRAY(Uint32Array, 4)
+  TYPED_ARRAY(Int32Array, 4)
+  TYPED_ARRAY(Float32Array, 4)
+  TYPED_ARRAY(Float64Array, 8)
+  TYPED_ARRAY(BigUint64Array, 8)
+  TYPED_ARRAY(BigInt64Array, 8)
+#undef TYPED_ARRAY
+  return v8::DataView::New(buffer, 0, length);
+}
+
+v8::MaybeLocal<v8::Value> PassObjectToOtherContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Object> object,
+    ObjectCache* cache,
+    int depth,
+    std::string* error) {
+  v8::Isolate* isolate = destination->GetIsolate();
+  v8::Local<v8::Object> result;
+  {
+    v8::Context::Scope destination_scope(destination);
+    if (object->IsArray())
+      result = v8::Array::New(isolate, object.As<v8::Array>()->Length());
+    else
+      result = v8::Object::New(isolate);
+  }
+  cache->Set(object, result);
+
+  // Only the own enumerable properties are copied, the prototype of the
+  // object belongs to the other world.
+  v8::Local<v8::Array> keys;
+  if (!object
+           ->GetOwnPropertyNames(source,
+                                 static_cast<v8::PropertyFilter>(
+                                     v8::ONLY_ENUMERABLE | v8::SKIP_SYMBOLS),
+                                 v8::KeyConversionMode::kConvertToString)
+           .ToLocal(&keys))
+    return v8::MaybeLocal<v8::Value>();
+  for (uint32_t i = 0; i < keys->Length(); ++i) {
+    v8::Local<v8::Value> key;
+    v8::Local<v8::Value> value;
+    if (!keys->Get(source, i).ToLocal(&key) ||
+        !object->Get(source, key).ToLocal(&value))
+      return v8::MaybeLocal<v8::Value>();
+    if (!PassValueToOtherContext(source, destination, value, cache, depth + 1,
+                                 error)
+             .ToLocal(&value))
+      return v8::MaybeLocal<v8::Value>();
+
+    // Setters the destination world defined on Object.prototype are not run.
+    v8::Context::Scope destination_scope(destination);
+    if (result->CreateDataProperty(destination, key.As<v8::String>(), value)
+            .IsNothing())
+      return v8::MaybeLocal<v8::Value>();
+  }
+  return result;
+}
+
+v8::MaybeLocal<v8::Value> PassValueToOtherContext(
+    v8::Local<v8::Context> source,
+    v8::Local<v8::Context> destination,
+    v8::Local<v8::Value> value,
+    ObjectCache* cache,
+    int depth,
+    std::string* error) {
+  // Primitives do not belong to a context.
+  if (!value->IsObject())
+    return value;
+
+  if (depth > kMaxRecursion) {
+    *error = "Object is too deeply nested to be passed over the context bridge";
+    return v8::MaybeLocal<v8::Value>();
+  }
+
+  v8::Local<v8::Object> object = value.As<v8::Object>();
+  v8::Local<v8::Value> result;
+  if (cache->Get(object, &result))
+    return result;
+
+  if (value->IsFunction()) {
+    v8::Context::Scope destination_scope(destination);
+    v8::Local<v8::Function> proxy;
+    if (!v8::Function::New(destination, ProxyFunctionWrapper, value)
+             .ToLocal(&proxy))
+      return v8::MaybeLocal<v8::Value>();
+    cache->Set(object, proxy);
+    return proxy;
+  }
+
+  if (value->IsPromise()) {
+    if (!PassPromiseToOtherContext(source, destination,
+                                   value.As<v8::Promise>())
+             .ToLocal(&result))
+      return v8::MaybeLocal<v8::Value>();
+  } else if (value->IsArrayBuffer()) {
+    auto buffer = value.As<v8::ArrayBuffer>();
+    v8::Context::Scope destination_scope(destination);
+    size_t length = buffer->ByteLength();
+    auto copy = v8::ArrayBuffer::New(destination->GetIsolate(), length);
+    if (length > 0)
+      memcpy(copy->GetContents().Data(), buffer->GetContents().Data(), length);
+    result = copy;
+  } else if (value->IsArrayBufferView()) {
+    if (!PassArrayBufferViewToOtherContext(destination,
+                                           value.As<v8::ArrayBufferView>())
+             .ToLocal(&result))
+      return v8::MaybeLocal<v8::Value>();
+  } else if (value->IsDate()) {
+    v8::Context::Scope destination_scope(destination);
+    if (!v8::Date::New(destination, value.As<v8::Date>()->ValueOf())
+             .ToLocal(&result))
+      return v8::MaybeLocal<v8::Value>();
+  } else if (value->IsProxy() || value->IsMap() || value->IsSet() ||
+             value->IsWeakMap() || value->IsWeakSet() || value->IsRegExp() ||
+             value->IsSymbolObject()) {
+    *error = "Object of this type can not be passed over the context bridge";
+    return v8::MaybeLocal<v8::Value>();
+  } else {
+    return PassObjectToOtherContext(source, destination, object, cache, depth,
+                                    error);
+  }
+
+  cache->Set(object, result);
+  return result;
+}
+
+// Copies |api| from the isolated world of the preload script into the main
+// world as window[key].
+void ExposeAPIInMainWorld(const std::string& key,
+                          v8::Local<v8::Value> api,
+                          mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  v8::Local<v8::Context> isolated_context = isolate->GetCurrentContext();
+  blink::WebLocalFrame* frame = blink::WebLocalFrame::FrameForCurrentContext();
+  if (!frame) {
+    args->ThrowError("Can not find the frame of the current context");
+    return;
+  }
+
+  v8::Local<v8::Context> main_context = frame->MainWorldScriptContext();
+  if (main_context == isolated_context) {
+    args->ThrowError(
+        "contextBridge can only be used when contextIsolation is enabled");
+    return;
+  }
+
+  v8::Local<v8::String> name = mate::StringToV8(isolate, key);
+  v8::Local<v8::Object> global = main_context->Global();
+  {
+    v8::Context::Scope main_scope(main_context);
+    if (global->HasOwnProperty(main_context, name).FromMaybe(true)) {
+      args->ThrowError(base::StringPrintf(
+          "Cannot bind an API on top of the existing property \"%s\" of the "
+          "window object",
+          key.c_str()));
+      return;
+    }
+  }
+
+  ObjectCache cache;
+  std::string error;
+  v8::Local<v8::Value> result;
+  if (!PassValueToOtherContext(isolated_context, main_context, api, &cache, 0,
+                               &error)
+           .ToLocal(&result)) {
+    if (!error.empty())
+      args->ThrowTypeError(error);
+    return;
+  }
+
+  v8::Context::Scope main_scope(main_context);
+  ignore_result(global->DefineOwnProperty(
+      main_context, name, result,
+      static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8::DontDelete)));
+}
+
+void Initialize(v8::Local<v8::Object> exports,
+                v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context,
+                void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("exposeAPIInMainWorld", &ExposeAPIInMainWorld);
+}
+
+}  // namespace
+
+NODE_BUILTIN_MODULE_CONTEXT_AWARE(atom_renderer_context_bridge, Initialize)
@@ -8,6 +8,9 @@
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
+#include "base/atomic_sequence_num.h"
+#include "base/process/process_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
 #include "native_mate/arguments.h"
@@ -27,16 +30,27 @@ RenderFrame* GetCurrentRenderFrame() {
   return RenderFrame::FromWebFrame(frame);
 }
 
+// Returns the id of the flow from a send to its dispatch in the browser, which
+// is carried in the message. The pid keeps it unique across renderers.
+uint64_t GetNextTraceId() {
+  static base::AtomicSequenceNumber sequence;
+  return (static_cast<uint64_t>(base::GetCurrentProcId()) << 32) |
+         static_cast<uint32_t>(sequence.GetNext() + 1);
+}
+
 void Send(mate::Arguments* args,
           bool internal,
           const std::string& channel,
           const base::ListValue& arguments) {
+  uint64_t trace_id = GetNextTraceId();
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "ipcRenderer.send", trace_id,
+                         TRACE_EVENT_FLAG_FLOW_OUT, "channel", channel);
   RenderFrame* render_frame = GetCurrentRenderFrame();
   if (render_frame == nullptr)
     return;
 
   bool success = render_frame->Send(new AtomFrameHostMsg_Message(
-      render_frame->GetRoutingID(), internal, channel, arguments));
+      render_frame->GetRoutingID(), internal, channel, arguments, trace_id));
 
   if (!success)
     args->ThrowError("Unable to send AtomFrameHostMsg_Message");
@@ -46,6 +60,9 @@ base::ListValue SendSync(mate::Arguments* args,
                          bool internal,
                          const std::string& channel,
                          const base::ListValue& arguments) {
+  uint64_t trace_id = GetNextTraceId();
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "ipcRenderer.sendSync", trace_id,
+                         TRACE_EVENT_FLAG_FLOW_OUT, "channel", channel);
   base::ListValue result;
 
   RenderFrame* render_frame = GetCurrentRenderFrame();
@@ -53,7 +70,8 @@ base::ListValue SendSync(mate::Arguments* args,
     return result;
 
   IPC::SyncMessage* message = new AtomFrameHostMsg_Message_Sync(
-      render_frame->GetRoutingID(), internal, channel, arguments, &result);
+      render_frame->GetRoutingID(), internal, channel, arguments, trace_id,
+      &result);
   bool success = render_frame->Send(message);
 
   if (!success)
@@ -68,27 +86,51 @@ void SendTo(mate::Arguments* args,
             int32_t web_contents_id,
             const std::string& channel,
             const base::ListValue& arguments) {
+  uint64_t trace_id = GetNextTraceId();
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "ipcRenderer.sendTo", trace_id,
+                         TRACE_EVENT_FLAG_FLOW_OUT, "channel", channel);
   RenderFrame* render_frame = GetCurrentRenderFrame();
   if (render_frame == nullptr)
     return;
 
   bool success = render_frame->Send(new AtomFrameHostMsg_Message_To(
       render_frame->GetRoutingID(), internal, send_to_all, web_contents_id,
-      channel, arguments));
+      channel, arguments, trace_id));
 
   if (!success)
     args->ThrowError("Unable to send AtomFrameHostMsg_Message_To");
 }
 
+void SendDirect(mate::Arguments* args,
+                int32_t channel_id,
+                const std::string& channel,
+                const base::ListValue& arguments) {
+  uint64_t trace_id = GetNextTraceId();
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "ipcRenderer.sendDirect", trace_id,
+                         TRACE_EVENT_FLAG_FLOW_OUT, "channel", channel);
+  RenderFrame* render_frame = GetCurrentRenderFrame();
+  if (render_frame == nullptr)
+    return;
+
+  bool success = render_frame->Send(new AtomFrameHostMsg_Message_Direct(
+      render_frame->GetRoutingID(), channel_id, channel, arguments, trace_id));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomFrameHostMsg_Message_Direct");
+}
+
 void SendToHost(mate::Arguments* args,
                 const std::string& channel,
                 const base::ListValue& arguments) {
+  uint64_t trace_id = GetNextTraceId();
+  TRACE_EVENT_WITH_FLOW1("electron.ipc", "ipcRenderer.sendToHost", trace_id,
+                         TRACE_EVENT_FLAG_FLOW_OUT, "channel", channel);
   RenderFrame* render_frame = GetCurrentRenderFrame();
   if (render_frame == nullptr)
     return;
 
   bool success = render_frame->Send(new AtomFrameHostMsg_Message_Host(
-      render_frame->GetRoutingID(), channel, arguments));
+      render_frame->GetRoutingID(), channel, arguments, trace_id));
 
   if (!success)
     args->ThrowError("Unable to send AtomFrameHostMsg_Message_Host");
@@ -102,6 +144,7 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("send", &Send);
   dict.SetMethod("sendSync", &SendSync);
   dict.SetMethod("sendTo", &SendTo);
+  dict.SetMethod("sendDirect", &SendDirect);
   dict.SetMethod("sendToHost", &SendToHost);
 }
 
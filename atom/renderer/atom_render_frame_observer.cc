@@ -12,16 +12,18 @@
 #include "atom/common/heap_snapshot.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/bind.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/threading/thread_restrictions.h"
 #include "base/trace_event/trace_event.h"
 #include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message_macros.h"
 #include "native_mate/dictionary.h"
 #include "net/base/net_module.h"
 #include "net/grit/net_resources.h"
 #include "third_party/blink/public/platform/web_isolated_world_info.h"
+#include "third_party/blink/public/platform/web_security_origin.h"
 #include "third_party/blink/public/web/blink.h"
 #include "third_party/blink/public/web/web_document.h"
 #include "third_party/blink/public/web/web_draggable_region.h"
@@ -34,6 +36,18 @@ namespace atom {
 
 namespace {
 
+// Reports the result of a heap snapshot, the frame might be gone by now.
+void OnHeapSnapshotWritten(int routing_id,
+                           const std::string& channel,
+                           bool success,
+                           int64_t bytes_written) {
+  base::ListValue args;
+  args.AppendBoolean(success);
+  args.AppendDouble(bytes_written);
+  content::RenderThread::Get()->Send(
+      new AtomFrameHostMsg_Message(routing_id, true, channel, args, 0));
+}
+
 bool GetIPCObject(v8::Isolate* isolate,
                   v8::Local<v8::Context> context,
                   bool internal,
@@ -51,15 +65,6 @@ bool GetIPCObject(v8::Isolate* isolate,
   return true;
 }
 
-std::vector<v8::Local<v8::Value>> ListValueToVector(
-    v8::Isolate* isolate,
-    const base::ListValue& list) {
-  v8::Local<v8::Value> array = mate::ConvertToV8(isolate, list);
-  std::vector<v8::Local<v8::Value>> result;
-  mate::ConvertFromV8(isolate, array, &result);
-  return result;
-}
-
 base::StringPiece NetResourceProvider(int key) {
   if (key == IDR_DIR_HEADER_HTML) {
     base::StringPiece html_data =
@@ -189,39 +194,64 @@ void AtomRenderFrameObserver::OnBrowserMessage(bool internal,
   if (!frame)
     return;
 
-  EmitIPCEvent(frame, internal, channel, args, sender_id);
+  MessageArguments message_args(args);
+  EmitIPCEvent(frame, internal, channel, &message_args, sender_id);
 
   // Also send the message to all sub-frames.
   if (send_to_all) {
     for (blink::WebFrame* child = frame->FirstChild(); child;
          child = child->NextSibling())
       if (child->IsWebLocalFrame()) {
-        EmitIPCEvent(child->ToWebLocalFrame(), internal, channel, args,
-                     sender_id);
+        EmitIPCEvent(child->ToWebLocalFrame(), internal, channel,
+                     &message_args, sender_id);
       }
   }
 }
 
 void AtomRenderFrameObserver::OnTakeHeapSnapshot(
     IPC::PlatformFileForTransit file_handle,
-    const std::string& channel) {
-  base::ThreadRestrictions::ScopedAllowIO allow_io;
+    const std::string& channel,
+    bool gzip) {
+  // Only the snapshot itself is taken on this thread, the file is written on
+  // a background sequence.
+  TakeHeapSnapshotAsync(
+      blink::MainThreadIsolate(),
+      IPC::PlatformFileForTransitToFile(file_handle), gzip,
+      HeapSnapshotProgressCallback(),
+      base::BindOnce(&OnHeapSnapshotWritten, render_frame_->GetRoutingID(),
+                     channel));
+}
 
-  auto file = IPC::PlatformFileForTransitToFile(file_handle);
-  bool success = TakeHeapSnapshot(blink::MainThreadIsolate(), &file);
+AtomRenderFrameObserver::MessageArguments::MessageArguments(
+    const base::ListValue& list)
+    : list_(list) {}
 
-  base::ListValue args;
-  args.AppendBoolean(success);
+AtomRenderFrameObserver::MessageArguments::~MessageArguments() = default;
 
-  render_frame_->Send(new AtomFrameHostMsg_Message(
-      render_frame_->GetRoutingID(), true, channel, args));
+v8::Local<v8::Array> AtomRenderFrameObserver::MessageArguments::Get(
+    v8::Isolate* isolate,
+    blink::WebLocalFrame* frame) {
+  // Frames that can access each other's objects can share the same values,
+  // the others get their own copy so no object leaks across origins.
+  if (converted_frame_ && frame->GetSecurityOrigin().CanAccess(
+                              converted_frame_->GetSecurityOrigin()))
+    return converted_.Get(isolate);
+
+  auto array = mate::ConvertToV8(isolate, list_).As<v8::Array>();
+  if (!converted_frame_) {
+    converted_frame_ = frame;
+    converted_.Reset(isolate, array);
+  }
+  return array;
 }
 
 void AtomRenderFrameObserver::EmitIPCEvent(blink::WebLocalFrame* frame,
                                            bool internal,
                                            const std::string& channel,
-                                           const base::ListValue& args,
+                                           MessageArguments* args,
                                            int32_t sender_id) {
+  TRACE_EVENT1("electron.ipc", "AtomRenderFrameObserver::EmitIPCEvent",
+               "channel", channel);
   if (!frame)
     return;
 
@@ -239,12 +269,20 @@ void AtomRenderFrameObserver::EmitIPCEvent(blink::WebLocalFrame* frame,
   v8::Local<v8::Object> ipc;
   if (GetIPCObject(isolate, context, internal, &ipc)) {
     TRACE_EVENT0("devtools.timeline", "FunctionCall");
-    auto args_vector = ListValueToVector(isolate, args);
+    v8::Local<v8::Array> array = args->Get(isolate, frame);
+    std::vector<v8::Local<v8::Value>> args_vector;
+    args_vector.reserve(array->Length() + 1);
     // Insert the Event object, event.sender is ipc.
     mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
     event.Set("sender", ipc);
     event.Set("senderId", sender_id);
-    args_vector.insert(args_vector.begin(), event.GetHandle());
+    args_vector.push_back(event.GetHandle());
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+      v8::Local<v8::Value> value;
+      if (!array->Get(context, i).ToLocal(&value))
+        return;
+      args_vector.push_back(value);
+    }
     mate::EmitEvent(isolate, ipc, channel, args_vector);
   }
 }
@@ -44,10 +44,29 @@ class AtomRenderFrameObserver : public content::RenderFrameObserver {
   void DidCreateDocumentElement() override;
 
  protected:
+  // The arguments of a message from the browser, converted to V8 at most once
+  // for the frames of a fan-out that can access each other.
+  class MessageArguments {
+   public:
+    explicit MessageArguments(const base::ListValue& list);
+    ~MessageArguments();
+
+    // Returns the arguments as an array for the current context, which must
+    // be a context of |frame|.
+    v8::Local<v8::Array> Get(v8::Isolate* isolate, blink::WebLocalFrame* frame);
+
+   private:
+    const base::ListValue& list_;
+    blink::WebLocalFrame* converted_frame_ = nullptr;
+    v8::Global<v8::Array> converted_;
+
+    DISALLOW_COPY_AND_ASSIGN(MessageArguments);
+  };
+
   virtual void EmitIPCEvent(blink::WebLocalFrame* frame,
                             bool internal,
                             const std::string& channel,
-                            const base::ListValue& args,
+                            MessageArguments* args,
                             int32_t sender_id);
 
  private:
@@ -61,7 +80,8 @@ class AtomRenderFrameObserver : public content::RenderFrameObserver {
                         const base::ListValue& args,
                         int32_t sender_id);
   void OnTakeHeapSnapshot(IPC::PlatformFileForTransit file_handle,
-                          const std::string& channel);
+                          const std::string& channel,
+                          bool gzip);
 
   content::RenderFrame* render_frame_;
   RendererClientBase* renderer_client_;
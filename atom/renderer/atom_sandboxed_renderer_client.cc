@@ -103,7 +103,7 @@ class AtomSandboxedRenderFrameObserver : public AtomRenderFrameObserver {
   void EmitIPCEvent(blink::WebLocalFrame* frame,
                     bool internal,
                     const std::string& channel,
-                    const base::ListValue& args,
+                    MessageArguments* args,
                     int32_t sender_id) override {
     if (!frame)
       return;
@@ -116,7 +116,7 @@ class AtomSandboxedRenderFrameObserver : public AtomRenderFrameObserver {
 
     v8::Local<v8::Value> argv[] = {mate::ConvertToV8(isolate, internal),
                                    mate::ConvertToV8(isolate, channel),
-                                   mate::ConvertToV8(isolate, args),
+                                   args->Get(isolate, frame),
                                    mate::ConvertToV8(isolate, sender_id)};
     renderer_client_->InvokeIpcCallback(
         context, "onMessage",
@@ -0,0 +1,18 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_test_suite.h"
+#include "gin/v8_initializer.h"
+
+int main(int argc, char** argv) {
+  base::PerfTestSuite test_suite(argc, argv);
+
+#if defined(V8_USE_EXTERNAL_STARTUP_DATA)
+  // The converter benchmarks need a working isolate.
+  gin::V8Initializer::LoadV8Snapshot();
+  gin::V8Initializer::LoadV8Natives();
+#endif
+
+  return test_suite.Run();
+}
@@ -23,6 +23,24 @@ Session.prototype._init = function () {
   app.emit('session-created', this)
 }
 
+Session.prototype.resolveProxies = function (urls, callback) {
+  if (!Array.isArray(urls)) throw new TypeError('urls must be an array')
+
+  const proxies = new Array(urls.length)
+  let remaining = urls.length
+  if (remaining === 0) {
+    process.nextTick(callback, proxies)
+    return
+  }
+
+  urls.forEach((url, index) => {
+    this.resolveProxy(url, (proxy) => {
+      proxies[index] = proxy
+      if (--remaining === 0) callback(proxies)
+    })
+  })
+}
+
 Cookies.prototype.flushStore = deprecate.promisify(Cookies.prototype.flushStore)
 Cookies.prototype.get = deprecate.promisify(Cookies.prototype.get)
 Cookies.prototype.remove = deprecate.promisify(Cookies.prototype.remove)
@@ -247,17 +247,17 @@ WebContents.prototype.getZoomFactor = function (callback) {
   }
 }
 
-WebContents.prototype.takeHeapSnapshot = function (filePath) {
+WebContents.prototype.takeHeapSnapshot = function (filePath, options = {}) {
   return new Promise((resolve, reject) => {
     const channel = `ELECTRON_TAKE_HEAP_SNAPSHOT_RESULT_${getNextId()}`
-    ipcMainInternal.once(channel, (event, success) => {
+    ipcMainInternal.once(channel, (event, success, bytesWritten) => {
       if (success) {
-        resolve()
+        resolve({ bytesWritten })
       } else {
         reject(new Error('takeHeapSnapshot failed'))
       }
     })
-    if (!this._takeHeapSnapshot(filePath, channel)) {
+    if (!this._takeHeapSnapshot(filePath, channel, !!options.gzip)) {
       ipcMainInternal.emit(channel, false)
     }
   })
@@ -370,6 +370,41 @@ const addReturnValueToEvent = (event) => {
   })
 }
 
+// Frame emitted by the 'paint' event when zero-copy painting is enabled, the
+// buffer is a view on the frame's pixels until the frame is released.
+class PaintFrame {
+  constructor (dirtyRect, buffer, width, height, stride, release) {
+    this.dirtyRect = dirtyRect
+    this.buffer = buffer
+    this.width = width
+    this.height = height
+    this.stride = stride
+    this._release = release
+  }
+
+  getDirtyRows (scaleFactor = 1) {
+    if (!this.buffer) throw new Error('The frame has been released')
+
+    const left = Math.max(0, Math.floor(this.dirtyRect.x * scaleFactor))
+    const top = Math.max(0, Math.floor(this.dirtyRect.y * scaleFactor))
+    const right = Math.min(this.width, Math.ceil((this.dirtyRect.x + this.dirtyRect.width) * scaleFactor))
+    const bottom = Math.min(this.height, Math.ceil((this.dirtyRect.y + this.dirtyRect.height) * scaleFactor))
+
+    const rows = []
+    for (let row = top; row < bottom; row++) {
+      const start = row * this.stride + left * 4
+      rows.push(this.buffer.subarray(start, start + Math.max(0, right - left) * 4))
+    }
+    return rows
+  }
+
+  release () {
+    if (!this.buffer) return
+    this.buffer = null
+    this._release()
+  }
+}
+
 // Add JavaScript wrappers for WebContents class.
 WebContents.prototype._init = function () {
   // The navigation controller.
@@ -415,6 +450,10 @@ WebContents.prototype._init = function () {
     })
   })
 
+  this.on('-paint-frame', function (event, dirtyRect, buffer, width, height, stride, release) {
+    this.emit('paint', event, dirtyRect, new PaintFrame(dirtyRect, buffer, width, height, stride, release))
+  })
+
   const forwardedEvents = [
     'desktop-capturer-get-sources',
     'remote-require',
@@ -489,6 +528,36 @@ Debugger.prototype.sendCommand = deprecate.promisify(Debugger.prototype.sendComm
 
 Object.setPrototypeOf(Debugger.prototype, EventEmitter.prototype)
 
+// Returns [webContentsId, frameId] of a WebContents or a
+// { webContents, frameId } object, frameId 0 means the main frame.
+const parseFrameTarget = function (target) {
+  if (target instanceof WebContents) {
+    return [target.id, 0]
+  } else if (target && target.webContents instanceof WebContents) {
+    return [target.webContents.id, typeof target.frameId === 'number' ? target.frameId : 0]
+  } else {
+    throw new Error('Invalid frame target')
+  }
+}
+
+const broadcast = function (internal, sendToAll, targets, channel, args) {
+  if (!Array.isArray(targets)) {
+    throw new Error('Missing required targets argument')
+  } else if (typeof channel !== 'string') {
+    throw new Error('Missing required channel argument')
+  }
+
+  const webContentsIds = []
+  const frameIds = []
+  for (const target of targets) {
+    const [webContentsId, frameId] = parseFrameTarget(target)
+    webContentsIds.push(webContentsId)
+    frameIds.push(frameId)
+  }
+
+  return binding._broadcast(internal, sendToAll, webContentsIds, frameIds, channel, args)
+}
+
 // Public APIs.
 module.exports = {
   create (options = {}) {
@@ -499,6 +568,35 @@ module.exports = {
     return binding.fromId(id)
   },
 
+  broadcast (targets, channel, ...args) {
+    const internal = false
+    const sendToAll = false
+
+    return broadcast(internal, sendToAll, targets, channel, args)
+  },
+
+  broadcastToAll (targets, channel, ...args) {
+    const internal = false
+    const sendToAll = true
+
+    return broadcast(internal, sendToAll, targets, channel, args)
+  },
+
+  createDirectChannel (first, second) {
+    const channelId = binding._createDirectChannel(...parseFrameTarget(first), ...parseFrameTarget(second))
+    if (channelId < 0) {
+      throw new Error('Unable to find a live frame for the direct channel')
+    }
+    return channelId
+  },
+
+  closeDirectChannel (channelId) {
+    if (typeof channelId !== 'number') {
+      throw new Error('Missing required channelId argument')
+    }
+    binding._closeDirectChannel(channelId)
+  },
+
   getFocusedWebContents () {
     let focused = null
     for (const contents of binding.getAllWebContents()) {
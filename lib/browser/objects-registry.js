@@ -46,17 +46,20 @@ class ObjectsRegistry {
     if (pointer != null) return pointer.object
   }
 
-  // Dereference an object according to its ID.
+  // Dereference objects according to their IDs, the renderer releases the
+  // objects freed by a GC in batches.
   // Note that an object may be double-freed (cleared when page is reloaded, and
   // then garbage collected in old page).
-  remove (webContents, contextId, id) {
+  remove (webContents, contextId, ids) {
     const ownerKey = getOwnerKey(webContents, contextId)
     const owner = this.owners[ownerKey]
     if (owner) {
-      // Remove the reference in owner.
-      owner.delete(id)
-      // Dereference from the storage.
-      this.dereference(id)
+      for (const id of ids) {
+        // Remove the reference in owner.
+        owner.delete(id)
+        // Dereference from the storage.
+        this.dereference(id)
+      }
     }
   }
 
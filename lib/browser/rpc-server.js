@@ -294,13 +294,17 @@ const handleRemoteCommand = function (channel, handler) {
   })
 }
 
+// |id| is an array of ids when the message that went to the wrong context was
+// a batch, like ELECTRON_RENDERER_RELEASE_CALLBACK.
 handleRemoteCommand('ELECTRON_BROWSER_WRONG_CONTEXT_ERROR', function (event, contextId, passedContextId, id) {
-  const objectId = [passedContextId, id]
-  if (!rendererFunctions.has(objectId)) {
+  const ids = Array.isArray(id) ? id : [id]
+  for (const id of ids) {
+    const objectId = [passedContextId, id]
     // Do nothing if the error has already been reported before.
-    return
+    if (rendererFunctions.has(objectId)) {
+      removeRemoteListenersAndLogWarning(event.sender, rendererFunctions.get(objectId))
+    }
   }
-  removeRemoteListenersAndLogWarning(event.sender, rendererFunctions.get(objectId))
 })
 
 handleRemoteCommand('ELECTRON_BROWSER_REQUIRE', function (event, contextId, moduleName) {
@@ -444,8 +448,9 @@ handleRemoteCommand('ELECTRON_BROWSER_MEMBER_GET', function (event, contextId, i
   return valueToMeta(event.sender, contextId, obj[name])
 })
 
-handleRemoteCommand('ELECTRON_BROWSER_DEREFERENCE', function (event, contextId, id) {
-  objectsRegistry.remove(event.sender, contextId, id)
+// The renderer releases its remote objects in batches of ids.
+handleRemoteCommand('ELECTRON_BROWSER_DEREFERENCE', function (event, contextId, ids) {
+  objectsRegistry.remove(event.sender, contextId, ids)
 })
 
 handleRemoteCommand('ELECTRON_BROWSER_CONTEXT_RELEASE', (event, contextId) => {
@@ -1,3 +1,83 @@
 'use strict'
 
-module.exports = process.atomBinding('native_image')
+const binding = process.atomBinding('native_image')
+
+// The asynchronous image methods run on the thread pool, the queue limits the
+// number of tasks in flight so that a burst of requests does not starve the
+// pool, and lets tasks that have not started yet be cancelled.
+let maxConcurrentTasks = 4
+let runningTasks = 0
+const pendingTasks = []
+
+const runNextTasks = function () {
+  while (runningTasks < maxConcurrentTasks && pendingTasks.length > 0) {
+    const task = pendingTasks.shift()
+    runningTasks++
+    let promise
+    try {
+      promise = Promise.resolve(task.start())
+    } catch (error) {
+      promise = Promise.reject(error)
+    }
+    promise.then(task.resolve, task.reject).then(() => {
+      runningTasks--
+      runNextTasks()
+    })
+  }
+}
+
+const enqueueTask = function (start) {
+  const task = { start }
+  const promise = new Promise((resolve, reject) => {
+    task.resolve = resolve
+    task.reject = reject
+  })
+
+  // Tasks waiting in the queue are dropped, the result of a task that is
+  // already running is ignored since the promise is settled.
+  promise.cancel = () => {
+    const index = pendingTasks.indexOf(task)
+    if (index !== -1) pendingTasks.splice(index, 1)
+    task.reject(new Error('Task was cancelled'))
+  }
+
+  pendingTasks.push(task)
+  runNextTasks()
+  return promise
+}
+
+const nativeImagePrototype = Object.getPrototypeOf(binding.createEmpty())
+
+nativeImagePrototype.toPNGAsync = function (options) {
+  return enqueueTask(() => this._toPNGAsync(options))
+}
+
+nativeImagePrototype.toJPEGAsync = function (quality) {
+  return enqueueTask(() => this._toJPEGAsync(quality))
+}
+
+nativeImagePrototype.toDataURLAsync = function (options) {
+  return enqueueTask(() => this._toDataURLAsync(options))
+}
+
+nativeImagePrototype.resizeAsync = function (options) {
+  return enqueueTask(() => this._resizeAsync(options))
+}
+
+binding.createFromPathAsync = function (path) {
+  return enqueueTask(() => binding._createFromPathAsync(path))
+}
+
+binding.createFromBufferAsync = function (buffer, options) {
+  return enqueueTask(() => binding._createFromBufferAsync(buffer, options))
+}
+
+binding.setMaxConcurrentTasks = function (limit) {
+  if (!Number.isInteger(limit) || limit < 1) {
+    throw new Error('limit must be a positive integer')
+  }
+  maxConcurrentTasks = limit
+  runNextTasks()
+}
+
+module.exports = binding
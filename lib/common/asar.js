@@ -649,8 +649,11 @@
       return files
     }
 
+    // Node probes many candidate paths for every require(), these hooks are
+    // answered natively for normalized paths and fall back to the JavaScript
+    // versions below for the others.
     const { internalModuleReadJSON } = process.binding('fs')
-    process.binding('fs').internalModuleReadJSON = pathArgument => {
+    const readJSONInAsar = pathArgument => {
       const { isAsar, asarPath, filePath } = splitPath(pathArgument)
       if (!isAsar) return internalModuleReadJSON(pathArgument)
 
@@ -673,9 +676,19 @@
       fs.readSync(fd, buffer, 0, info.size, info.offset)
       return buffer.toString('utf8')
     }
+    process.binding('fs').internalModuleReadJSON = pathArgument => {
+      if (isAsarDisabled()) return internalModuleReadJSON(pathArgument)
+      // The reads have to go through JavaScript to be logged.
+      if (process.env.ELECTRON_LOG_ASAR_READS) return readJSONInAsar(pathArgument)
+
+      const result = asar.internalModuleReadJSON(pathArgument)
+      if (result === false) return internalModuleReadJSON(pathArgument)
+      if (result === null) return readJSONInAsar(pathArgument)
+      return result
+    }
 
     const { internalModuleStat } = process.binding('fs')
-    process.binding('fs').internalModuleStat = pathArgument => {
+    const statInAsar = pathArgument => {
       const { isAsar, asarPath, filePath } = splitPath(pathArgument)
       if (!isAsar) return internalModuleStat(pathArgument)
 
@@ -689,6 +702,14 @@
 
       return (stats.isDirectory) ? 1 : 0
     }
+    process.binding('fs').internalModuleStat = pathArgument => {
+      if (isAsarDisabled()) return internalModuleStat(pathArgument)
+
+      const result = asar.internalModuleStat(pathArgument)
+      if (result === false) return internalModuleStat(pathArgument)
+      if (result === null) return statInAsar(pathArgument)
+      return result
+    }
 
     // Calling mkdir for directory inside asar archive should throw ENOTDIR
     // error, but on Windows it throws ENOENT.
@@ -0,0 +1,12 @@
+'use strict'
+
+const binding = process.atomBinding('context_bridge')
+
+module.exports = {
+  exposeInMainWorld (key, api) {
+    if (typeof key !== 'string') {
+      throw new TypeError('The key of the API must be a string')
+    }
+    binding.exposeAPIInMainWorld(key, api)
+  }
+}
@@ -27,4 +27,8 @@ ipcRenderer.sendToAll = function (webContentsId, channel, ...args) {
   return binding.sendTo(internal, true, webContentsId, channel, args)
 }
 
+ipcRenderer.sendDirect = function (channelId, channel, ...args) {
+  return binding.sendDirect(channelId, channel, args)
+}
+
 module.exports = ipcRenderer
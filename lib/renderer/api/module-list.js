@@ -8,6 +8,7 @@ const enableRemoteModule = v8Util.getHiddenValue(global, 'enableRemoteModule')
 // Renderer side modules, please sort alphabetically.
 // A module is `enabled` if there is no explicit condition defined.
 module.exports = [
+  { name: 'contextBridge', file: 'context-bridge' },
   { name: 'crashReporter', file: 'crash-reporter', enabled: true },
   {
     name: 'desktopCapturer',
@@ -269,6 +269,9 @@ function metaToPlainObject (meta) {
   return obj
 }
 
+// |id| is the id of the callback the message is about, or an array of ids for
+// a batch like ELECTRON_RENDERER_RELEASE_CALLBACK. It is reported back as is
+// when the context is gone.
 function handleMessage (channel, handler) {
   ipcRendererInternal.on(channel, (event, passedContextId, id, ...args) => {
     if (passedContextId === contextId) {
@@ -285,9 +288,11 @@ handleMessage('ELECTRON_RENDERER_CALLBACK', (id, args) => {
   callbacksRegistry.apply(id, metaToValue(args))
 })
 
-// A callback in browser is released.
-handleMessage('ELECTRON_RENDERER_RELEASE_CALLBACK', (id) => {
-  callbacksRegistry.remove(id)
+// Callbacks in browser are released, in batches of ids.
+handleMessage('ELECTRON_RENDERER_RELEASE_CALLBACK', (ids) => {
+  for (const id of ids) {
+    callbacksRegistry.remove(id)
+  }
 })
 
 exports.require = (module) => {
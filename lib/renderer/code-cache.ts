@@ -0,0 +1,145 @@
+import * as crypto from 'crypto'
+import * as fs from 'fs'
+import * as path from 'path'
+import * as vm from 'vm'
+
+const Module = require('module')
+// The module object Node's loader calls, which the import cannot reassign.
+const vmModule = require('vm')
+
+// Every entry starts with the hash of the source it was compiled from, so an
+// entry of a file that changed, inside an asar archive or not, is not used.
+const hash = (value: string) => crypto.createHash('sha1').update(value).digest()
+const HASH_LENGTH = 20
+
+// Writing is deferred until the page has loaded, by then the functions that
+// run on startup have been compiled and are included in the cached data.
+const WRITE_DELAY = 1000
+
+// Once the entries take more than this, the least recently used ones are
+// deleted until they take less than PRUNED_CACHE_SIZE.
+const MAX_CACHE_SIZE = 50 * 1024 * 1024
+const PRUNED_CACHE_SIZE = 40 * 1024 * 1024
+
+interface CompileResult {
+  cachedData: boolean
+  cachedDataRejected: boolean
+}
+
+const compileResults = new Map<string, CompileResult>()
+
+// Returns whether the module at |filename| was compiled with cached data.
+export const getCompileResult = (filename: string) => compileResults.get(filename)
+
+// Persists the code V8 compiles for the modules required from now on in
+// |cachePath|, keyed by their path.
+export const installCodeCache = (cachePath: string) => {
+  try {
+    fs.mkdirSync(cachePath, { recursive: true })
+  } catch {
+    return
+  }
+
+  const pendingWrites = new Map<string, { sourceHash: Buffer, script: vm.Script }>()
+
+  // The modification time of an entry is when it was last used, a used entry
+  // is touched when it is read.
+  const pruneEntries = async () => {
+    try {
+      const entries: { entryPath: string, size: number, lastUsed: number }[] = []
+      let size = 0
+      for (const name of await fs.promises.readdir(cachePath)) {
+        const entryPath = path.join(cachePath, name)
+        const stats = await fs.promises.stat(entryPath)
+        entries.push({ entryPath, size: stats.size, lastUsed: stats.mtimeMs })
+        size += stats.size
+      }
+      if (size <= MAX_CACHE_SIZE) return
+
+      entries.sort((a, b) => a.lastUsed - b.lastUsed)
+      for (const entry of entries) {
+        if (size <= PRUNED_CACHE_SIZE) break
+        await fs.promises.unlink(entry.entryPath)
+        size -= entry.size
+      }
+    } catch {
+      // Another renderer may be pruning at the same time.
+    }
+  }
+
+  // Entries are written to a temporary file first, so a renderer reading an
+  // entry while another one writes it never sees a partial entry.
+  const writeEntry = (entryPath: string, data: Buffer) => {
+    const tempPath = `${entryPath}.${process.pid}.tmp`
+    return fs.promises.writeFile(tempPath, data)
+      .then(() => fs.promises.rename(tempPath, entryPath))
+      .catch(() => fs.promises.unlink(tempPath).catch(() => {}))
+  }
+
+  const writePendingEntries = () => {
+    const writes: Promise<void>[] = []
+    for (const [entryPath, { sourceHash, script }] of pendingWrites) {
+      const data = Buffer.concat([sourceHash, script.createCachedData()])
+      writes.push(writeEntry(entryPath, data))
+    }
+    pendingWrites.clear()
+    Promise.all(writes).then(pruneEntries)
+  }
+
+  const scheduleWrite = (entryPath: string, sourceHash: Buffer, script: vm.Script) => {
+    if (pendingWrites.size === 0) {
+      if (document.readyState === 'complete') {
+        setTimeout(writePendingEntries, WRITE_DELAY)
+      } else {
+        window.addEventListener('load', () => setTimeout(writePendingEntries, WRITE_DELAY), { once: true })
+      }
+    }
+    pendingWrites.set(entryPath, { sourceHash, script })
+  }
+
+  const readEntry = (entryPath: string, sourceHash: Buffer) => {
+    try {
+      const entry = fs.readFileSync(entryPath)
+      if (entry.slice(0, HASH_LENGTH).equals(sourceHash)) {
+        const now = new Date()
+        fs.utimes(entryPath, now, now, () => {})
+        return entry.slice(HASH_LENGTH)
+      }
+    } catch {
+      // Not compiled before.
+    }
+  }
+
+  // Node compiles a module with vm.runInThisContext once Module.wrap has been
+  // replaced, which leaves the rest of Module.prototype._compile (shebangs,
+  // policies, --inspect-brk and the module's require) to Node. The wrapped
+  // sources are remembered to tell module compiles from other callers.
+  const wrap = Module.wrap
+  const wrappedSources = new Set<string>()
+  Module.wrap = (script: string) => {
+    const wrapped = wrap(script)
+    wrappedSources.add(wrapped)
+    return wrapped
+  }
+
+  const runInThisContext = vmModule.runInThisContext
+  vmModule.runInThisContext = (code: string, options?: any) => {
+    if (!wrappedSources.delete(code) || !options || typeof options.filename !== 'string') {
+      return runInThisContext(code, options)
+    }
+
+    const { filename } = options
+    const entryPath = path.join(cachePath, hash(filename).toString('hex'))
+    const sourceHash = hash(code)
+    const cachedData = readEntry(entryPath, sourceHash)
+
+    const script = new vm.Script(code, { ...options, cachedData })
+    // The data is rejected when it was created by another version of V8.
+    const cachedDataRejected = !!cachedData && !!script.cachedDataRejected
+    compileResults.set(filename, { cachedData: !!cachedData, cachedDataRejected })
+    if (!cachedData || cachedDataRejected) {
+      scheduleWrite(entryPath, sourceHash, script)
+    }
+    return script.runInThisContext(options)
+  }
+}
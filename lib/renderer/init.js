@@ -50,6 +50,8 @@ const preloadScripts = parseOption('preload-scripts', [], value => value.split(p
 const appPath = parseOption('app-path', null)
 const guestInstanceId = parseOption('guest-instance-id', null, value => parseInt(value))
 const openerId = parseOption('opener-id', null, value => parseInt(value))
+const codeCacheSchemes = parseOption('code-cache-schemes', [], value => value.split(','))
+const codeCachePath = parseOption('code-cache-path', null)
 
 // The arguments to be passed to isolated world.
 const isolatedWorldArgs = { ipcRendererInternal, guestInstanceId, isHiddenPage, openerId, usesNativeWindowOpen }
@@ -59,6 +61,11 @@ if (preloadScript) {
   preloadScripts.push(preloadScript)
 }
 
+// Keep the code compiled for the modules required by trusted local pages.
+if (codeCachePath && codeCacheSchemes.includes(window.location.protocol.slice(0, -1))) {
+  require('@electron/internal/renderer/code-cache').installCodeCache(codeCachePath)
+}
+
 switch (window.location.protocol) {
   case 'chrome-devtools:': {
     // Override some inspector APIs.
@@ -3,6 +3,10 @@
 const features = process.atomBinding('features')
 
 module.exports = [
+  {
+    name: 'contextBridge',
+    load: () => require('@electron/internal/renderer/api/context-bridge')
+  },
   {
     name: 'crashReporter',
     load: () => require('@electron/internal/renderer/api/crash-reporter')
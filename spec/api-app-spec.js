@@ -226,6 +226,32 @@ describe('app module', () => {
         })
       })
     })
+
+    it('hands the second launch over before it starts the browser', async function () {
+      this.timeout(120000)
+      const appPath = path.join(__dirname, 'fixtures', 'api', 'singleton-argv')
+      const args = ['--early-single-instance', appPath]
+      const first = ChildProcess.spawn(remote.process.execPath, args)
+      const firstExit = emittedOnce(first, 'exit')
+      let firstOutput = ''
+      first.stdout.on('data', data => { firstOutput += data })
+      await emittedOnce(first.stdout, 'data')
+
+      const second = ChildProcess.spawn(remote.process.execPath, [...args, '--second-instance-arg'])
+      let secondOutput = ''
+      second.stdout.on('data', data => { secondOutput += data })
+      const [secondCode] = await emittedOnce(second, 'exit')
+      expect(secondCode).to.equal(0)
+      // The main script of the second instance never ran.
+      expect(secondOutput).to.equal('')
+
+      const [firstCode] = await firstExit
+      expect(firstCode).to.equal(0)
+      const lines = firstOutput.trim().split('\n')
+      expect(lines[0]).to.equal('started')
+      const argv = JSON.parse(lines[lines.length - 1])
+      expect(argv).to.include('--second-instance-arg')
+    })
   })
 
   describe('app.relaunch', () => {
@@ -2545,6 +2545,42 @@ describe('BrowserWindow module', () => {
       })
       w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'))
     })
+    it('subscribes to frame updates with options', (done) => {
+      let called = false
+      w.webContents.on('did-finish-load', () => {
+        const options = { maxFrameRate: 10, size: { width: 100, height: 80 }, zeroCopy: true }
+        w.webContents.beginFrameSubscription(options, (data, rect, info) => {
+          if (data.length === 0) return
+          // This callback might be called twice.
+          if (called) return
+          called = true
+
+          expect(info.format).to.equal('bgra')
+          expect(rect.width).to.be.at.most(100)
+          expect(rect.height).to.be.at.most(80)
+          expect(info.strides[0]).to.be.at.least(rect.width * 4)
+          expect(data.length).to.equal(info.strides[0] * (rect.height - 1) + rect.width * 4)
+          info.release()
+          expect(data.length).to.equal(0)
+          w.webContents.endFrameSubscription()
+          done()
+        })
+      })
+      w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'))
+    })
+    it('throws error when the format is not supported', () => {
+      expect(() => {
+        w.webContents.beginFrameSubscription({ format: 'rgb' }, () => {})
+      }).to.throw(/format must be either/)
+    })
+    it('throws error when maxFrameRate is not a positive integer', () => {
+      expect(() => {
+        w.webContents.beginFrameSubscription({ maxFrameRate: 0.5 }, () => {})
+      }).to.throw(/maxFrameRate must be a positive integer/)
+      expect(() => {
+        w.webContents.beginFrameSubscription({ maxFrameRate: 0 }, () => {})
+      }).to.throw(/maxFrameRate must be a positive integer/)
+    })
     it('throws error when subscriber is not well defined', (done) => {
       w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'))
       try {
@@ -3706,6 +3742,28 @@ describe('BrowserWindow module', () => {
         w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'))
       })
     })
+
+    describe('window.webContents.setZeroCopyPaint(enabled)', () => {
+      it('passes frames sharing the paint buffer', (done) => {
+        w.webContents.setZeroCopyPaint(true)
+        assert.strictEqual(w.webContents.isZeroCopyPaint(), true)
+        w.webContents.once('paint', function (event, rect, frame) {
+          const scale = process.platform === 'darwin' ? devicePixelRatio : 1
+          assertWithinDelta(frame.width, 100 * scale, 2, 'width')
+          assertWithinDelta(frame.height, 100 * scale, 2, 'height')
+          assert.ok(frame.stride >= frame.width * 4)
+          assert.ok(frame.buffer.length >= frame.stride * frame.height)
+          const rows = frame.getDirtyRows(scale)
+          assert.ok(rows.length > 0)
+          frame.release()
+          assert.strictEqual(frame.buffer, null)
+          assert.strictEqual(rows[0].length, 0)
+          assert.throws(() => frame.getDirtyRows(), /released/)
+          done()
+        })
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'))
+      })
+    })
   })
 })
 
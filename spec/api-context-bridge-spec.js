@@ -0,0 +1,122 @@
+const chai = require('chai')
+const dirtyChai = require('dirty-chai')
+const path = require('path')
+const { closeWindow } = require('./window-helpers')
+const { contextBridge, remote } = require('electron')
+const { BrowserWindow } = remote
+
+const { expect } = chai
+chai.use(dirtyChai)
+
+describe('contextBridge module', () => {
+  const fixtures = path.resolve(__dirname, 'fixtures')
+  let w = null
+
+  afterEach(async () => {
+    await closeWindow(w)
+    w = null
+  })
+
+  it('throws when contextIsolation is disabled', () => {
+    expect(() => {
+      contextBridge.exposeInMainWorld('bridge', {})
+    }).to.throw(/contextIsolation/)
+  })
+
+  const generateTests = (sandbox) => {
+    it('exposes the API to the main world', async () => {
+      w = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          contextIsolation: true,
+          sandbox,
+          preload: path.join(fixtures, 'api', 'context-bridge-preload.js')
+        }
+      })
+      await w.loadFile(path.join(fixtures, 'api', 'blank.html'))
+      const result = await w.webContents.executeJavaScript(`(async () => {
+        const { bridge } = window
+        let error
+        try {
+          bridge.fail()
+        } catch (e) {
+          error = e.message
+        }
+        return {
+          name: bridge.name,
+          list: bridge.nested.list,
+          shared: bridge.first === bridge.second,
+          bytes: Array.from(bridge.bytes),
+          isUint8Array: bridge.bytes instanceof Uint8Array,
+          isPageObject: Object.getPrototypeOf(bridge) === Object.prototype,
+          sum: bridge.add(1, 2),
+          callback: bridge.call(value => value + ' world'),
+          resolved: await bridge.resolve({ ok: true }),
+          error,
+          typeofRequire: bridge.typeofRequire()
+        }
+      })()`)
+      expect(result).to.deep.equal({
+        name: 'bridge',
+        list: [1, 'two', { three: 3 }],
+        shared: true,
+        bytes: [1, 2, 3],
+        isUint8Array: true,
+        isPageObject: true,
+        sum: 3,
+        callback: 'isolated world',
+        resolved: { ok: true },
+        error: 'isolated failure',
+        typeofRequire: 'function'
+      })
+    })
+
+    it('does not let errors of the isolated world reach the main world', async () => {
+      w = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          contextIsolation: true,
+          sandbox,
+          preload: path.join(fixtures, 'api', 'context-bridge-preload.js')
+        }
+      })
+      await w.loadFile(path.join(fixtures, 'api', 'blank.html'))
+      const result = await w.webContents.executeJavaScript(`(async () => {
+        const { bridge } = window
+        const errors = []
+        try {
+          bridge.throwingGetter()
+        } catch (e) {
+          errors.push(e)
+        }
+        try {
+          bridge.throwingObject()
+        } catch (e) {
+          errors.push(e)
+        }
+        try {
+          await bridge.resolveThrowingGetter()
+        } catch (e) {
+          errors.push(e)
+        }
+        return errors.map(e => ({
+          message: e.message,
+          isPageError: e instanceof Error && e.constructor.constructor === Function
+        }))
+      })()`)
+      expect(result).to.deep.equal([
+        { message: 'isolated getter', isPageError: true },
+        { message: 'An unknown exception occurred', isPageError: true },
+        { message: 'isolated getter', isPageError: true }
+      ])
+    })
+  }
+
+  describe('without sandbox', () => {
+    generateTests(false)
+  })
+
+  describe('with sandbox', () => {
+    generateTests(true)
+  })
+})
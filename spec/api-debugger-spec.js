@@ -201,6 +201,76 @@ describe('debugger module', () => {
       w.webContents.debugger.sendCommand('Console.enable')
     })
 
+    it('accepts params serialized to JSON', async () => {
+      w.webContents.loadURL('about:blank')
+      w.webContents.debugger.attach()
+
+      const params = JSON.stringify({ 'expression': '4+2' })
+      const res = await w.webContents.debugger.sendCommand('Runtime.evaluate', params)
+
+      expect(res.result.value).to.equal(6)
+
+      w.webContents.debugger.detach()
+    })
+
+    it('rejects serialized params that add members to the request', async () => {
+      w.webContents.loadURL('about:blank')
+      w.webContents.debugger.attach()
+
+      const params = '{ "expression": "4+2" }, "id": 1'
+      const promise = w.webContents.debugger.sendCommand('Runtime.evaluate', params)
+      await expect(promise).to.be.eventually.rejectedWith(TypeError, /JSON serialized object/)
+
+      w.webContents.debugger.detach()
+    })
+
+    it('rejects malformed serialized params', async () => {
+      w.webContents.loadURL('about:blank')
+      w.webContents.debugger.attach()
+
+      const params = '{ "expression": "4+2"'
+      const promise = w.webContents.debugger.sendCommand('Runtime.evaluate', params)
+      await expect(promise).to.be.eventually.rejectedWith(TypeError, /JSON serialized object/)
+
+      w.webContents.debugger.detach()
+    })
+
+    it('returns JSON strings when the message format is json', async () => {
+      w.webContents.loadURL('about:blank')
+      w.webContents.debugger.attach()
+      w.webContents.debugger.setMessageFormat('json')
+
+      const params = { 'expression': '4+2' }
+      const res = await w.webContents.debugger.sendCommand('Runtime.evaluate', params)
+
+      expect(res).to.be.a('string')
+      expect(JSON.parse(res).result.value).to.equal(6)
+
+      w.webContents.debugger.detach()
+    })
+
+    it('throws for an invalid message format', () => {
+      expect(() => {
+        w.webContents.debugger.setMessageFormat('xml')
+      }).to.throw(/Invalid message format/)
+    })
+
+    it('only emits the events allowed by the event filter', done => {
+      w.webContents.loadFile(path.join(fixtures, 'pages', 'a.html'))
+      w.webContents.debugger.attach()
+      w.webContents.debugger.setEventFilter(['Console.*'])
+
+      w.webContents.debugger.on('message', (e, method) => {
+        expect(method).to.match(/^Console\./)
+        if (method === 'Console.messageAdded') {
+          w.webContents.debugger.detach()
+          done()
+        }
+      })
+      w.webContents.debugger.sendCommand('Page.enable')
+      w.webContents.debugger.sendCommand('Console.enable')
+    })
+
     it('returns error message when command fails', async () => {
       w.webContents.loadURL('about:blank')
       w.webContents.debugger.attach()
@@ -407,6 +407,67 @@ describe('nativeImage module', () => {
     })
   })
 
+  describe('asynchronous methods', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('createFromPathAsync() loads images', async () => {
+      const image = await nativeImage.createFromPathAsync(logoPath)
+      expect(image.isEmpty()).to.be.false()
+      expect(image.getSize()).to.deep.equal({ width: 538, height: 190 })
+
+      const missing = await nativeImage.createFromPathAsync('does-not-exist.png')
+      expect(missing.isEmpty()).to.be.true()
+    })
+
+    it('createFromBufferAsync() decodes images', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const decoded = await nativeImage.createFromBufferAsync(image.toPNG())
+      expect(decoded.getSize()).to.deep.equal(image.getSize())
+      expect(decoded.toBitmap().equals(image.toBitmap())).to.be.true()
+    })
+
+    it('toPNGAsync() and toJPEGAsync() encode images', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const png = await image.toPNGAsync()
+      expect(nativeImage.createFromBuffer(png).getSize()).to.deep.equal(image.getSize())
+      const jpeg = await image.toJPEGAsync(80)
+      expect(jpeg.equals(image.toJPEG(80))).to.be.true()
+    })
+
+    it('toDataURLAsync() returns the same data URL as toDataURL()', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      expect(await image.toDataURLAsync()).to.equal(image.toDataURL())
+    })
+
+    it('resizeAsync() returns a resized image', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const resized = await image.resizeAsync({ width: 269 })
+      expect(resized.getSize()).to.deep.equal({ width: 269, height: 95 })
+      const empty = await image.resizeAsync({ width: 0, height: 0 })
+      expect(empty.isEmpty()).to.be.true()
+    })
+
+    it('can cancel queued tasks', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      nativeImage.setMaxConcurrentTasks(1)
+      try {
+        const first = image.toPNGAsync({ scaleFactor: 2.0 })
+        const second = image.toPNGAsync({ scaleFactor: 2.0 })
+        second.cancel()
+        let error = null
+        try {
+          await second
+        } catch (e) {
+          error = e
+        }
+        expect(error).to.be.an('error').with.property('message').that.matches(/cancelled/)
+        expect(await first).to.be.an.instanceof(Buffer)
+      } finally {
+        nativeImage.setMaxConcurrentTasks(4)
+      }
+    })
+  })
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       expect(nativeImage.createEmpty().crop({ width: 1, height: 2, x: 0, y: 0 }).isEmpty())
@@ -1,6 +1,7 @@
 const { remote } = require('electron')
 const fs = require('fs')
 const path = require('path')
+const zlib = require('zlib')
 
 const { expect } = require('chai')
 
@@ -101,4 +102,100 @@ describe('process module', () => {
       expect(success).to.be.false()
     })
   })
+
+  describe('process.writeHeapSnapshot()', () => {
+    const filePath = path.join(remote.app.getPath('temp'), 'test-async.heapsnapshot')
+
+    afterEach(() => {
+      try {
+        fs.unlinkSync(filePath)
+      } catch (e) {
+        // ignore error
+      }
+    })
+
+    it('resolves with the number of bytes written', async () => {
+      const progress = []
+      const { bytesWritten } = await process.writeHeapSnapshot(filePath, {
+        onProgress: (bytes) => progress.push(bytes)
+      })
+      expect(bytesWritten).to.be.above(0)
+      expect(fs.statSync(filePath).size).to.equal(bytesWritten)
+      expect(progress).to.not.be.empty()
+      expect(progress[progress.length - 1]).to.equal(bytesWritten)
+      JSON.parse(fs.readFileSync(filePath, 'utf8'))
+    })
+
+    it('can compress the snapshot with gzip', async () => {
+      const { bytesWritten } = await process.writeHeapSnapshot(filePath, { gzip: true })
+      const compressed = fs.readFileSync(filePath)
+      expect(compressed.length).to.equal(bytesWritten)
+      JSON.parse(zlib.gunzipSync(compressed).toString())
+    })
+
+    it('rejects on failure', async () => {
+      let error
+      try {
+        await process.writeHeapSnapshot('')
+      } catch (e) {
+        error = e
+      }
+      expect(error).to.be.an('error')
+    })
+  })
+
+  describe('process.startCpuProfile()', () => {
+    it('records a CPU profile', async () => {
+      process.startCpuProfile({ samplingInterval: 100 })
+      expect(() => process.startCpuProfile()).to.throw(/already being recorded/)
+
+      const start = Date.now()
+      while (Date.now() - start < 50) {
+        // keep the CPU busy
+      }
+
+      const profile = JSON.parse(await process.stopCpuProfile())
+      expect(profile.nodes).to.be.an('array').that.is.not.empty()
+      expect(profile.samples).to.have.lengthOf(profile.timeDeltas.length)
+      expect(profile.endTime).to.be.at.least(profile.startTime)
+    })
+
+    it('rejects stopping when no profile is being recorded', async () => {
+      let error
+      try {
+        await process.stopCpuProfile()
+      } catch (e) {
+        error = e
+      }
+      expect(error).to.be.an('error')
+    })
+  })
+
+  describe('process.startSamplingHeapProfile()', () => {
+    it('records a sampling heap profile', async () => {
+      process.startSamplingHeapProfile({ samplingInterval: 1024 })
+      expect(() => process.startSamplingHeapProfile()).to.throw(/already being recorded/)
+
+      const retained = []
+      for (let i = 0; i < 1000; i++) {
+        retained.push(new Array(100).fill(i))
+      }
+
+      const profile = JSON.parse(await process.stopSamplingHeapProfile())
+      expect(profile.head.callFrame).to.be.an('object')
+      expect(profile.head.children).to.be.an('array')
+      expect(profile.samples).to.be.an('array').that.is.not.empty()
+      expect(retained).to.have.lengthOf(1000)
+    })
+
+    it('rejects stopping when no profile is being recorded', async () => {
+      let error
+      try {
+        await process.stopSamplingHeapProfile()
+      } catch (e) {
+        error = e
+      }
+      expect(error).to.be.an('error')
+    })
+  })
 })
@@ -276,6 +276,41 @@ describe('remote module', () => {
     })
   })
 
+  describe('remote object release', () => {
+    it('releases many garbage collected remote objects in batches', async () => {
+      const factory = remote.require(path.join(fixtures, 'module', 'remote-object-factory.js'))
+      let objects = factory.create(2000)
+      assert.strictEqual(objects.length, 2000)
+      assert.strictEqual(factory.countReferenced(), 2000)
+
+      const contents = remote.getCurrentWebContents()
+      factory.watchDereferences(contents)
+      objects = null
+      global.gc()
+      await new Promise(resolve => setTimeout(resolve, 100))
+      const messages = factory.unwatchDereferences(contents)
+      assert.strictEqual(factory.countReferenced(), 0)
+      // Sent one by one, each object would take a message of its own.
+      assert(messages > 0 && messages <= 10, `${messages} messages`)
+    })
+
+    it('keeps an object that is fetched again before its release is sent', async () => {
+      const factory = remote.require(path.join(fixtures, 'module', 'remote-object-factory.js'))
+      let object = factory.getShared()
+      assert.strictEqual(object.index, -1)
+
+      // The release of the collected proxy is still pending when the object
+      // is fetched again in the same task.
+      object = null
+      global.gc()
+      const fetched = factory.getShared()
+
+      await new Promise(resolve => setTimeout(resolve, 100))
+      assert.strictEqual(factory.isSharedReferenced(), true)
+      assert.strictEqual(fetched.index, -1)
+    })
+  })
+
   describe('remote value in browser', () => {
     const print = path.join(fixtures, 'module', 'print_name.js')
     const printName = remote.require(print)
@@ -1,5 +1,6 @@
 const assert = require('assert')
 const chai = require('chai')
+const dirtyChai = require('dirty-chai')
 const http = require('http')
 const https = require('https')
 const path = require('path')
@@ -8,10 +9,12 @@ const send = require('send')
 const auth = require('basic-auth')
 const ChildProcess = require('child_process')
 const { closeWindow } = require('./window-helpers')
+const { emittedOnce } = require('./events-helpers')
 
 const { ipcRenderer, remote } = require('electron')
 const { ipcMain, session, BrowserWindow, net } = remote
 const { expect } = chai
+chai.use(dirtyChai)
 
 /* The whole session API doesn't use standard callbacks */
 /* eslint-disable standard/no-callback-literal */
@@ -198,6 +201,46 @@ describe('session module', () => {
       })
     })
 
+    it('sets and removes many cookies at once', async () => {
+      const { cookies } = session.defaultSession
+      const details = []
+      for (let i = 0; i < 100; i++) {
+        details.push({ url, name: `many${i}`, value: `${i}` })
+      }
+
+      await cookies.setMany(details)
+      let list = await cookies.get({ url })
+      expect(list.filter(cookie => cookie.name.startsWith('many'))).to.have.lengthOf(100)
+
+      const [ cookie ] = await cookies.get({ url, name: 'many42' })
+      expect(cookie).to.have.property('value').which.equals('42')
+
+      await cookies.removeMany(details.map(({ url, name }) => ({ url, name })))
+      list = await cookies.get({ url })
+      expect(list.some(cookie => cookie.name.startsWith('many'))).to.be.false()
+    })
+
+    it('rejects setMany when some of the cookies cannot be set', async () => {
+      const { cookies } = session.defaultSession
+      let error
+      try {
+        await cookies.setMany([{ url, name: 'good', value: '1' }, { url: '', name: 'bad', value: '1' }])
+      } catch (e) {
+        error = e
+      }
+      expect(error).to.have.property('message').which.equals('Setting 1 cookie(s) failed')
+      const list = await cookies.get({ url, name: 'good' })
+      expect(list).to.have.lengthOf(1)
+    })
+
+    it('filters cookies by domain', async () => {
+      const { cookies } = session.defaultSession
+      await cookies.set({ url: 'http://sub.filter-domain.test', name: 'sub', value: '1' })
+      await cookies.set({ url: 'http://otherfilter-domain.test', name: 'other', value: '1' })
+      const list = await cookies.get({ domain: 'filter-domain.test' })
+      expect(list.map(cookie => cookie.name)).to.deep.equal(['sub'])
+    })
+
     it('should set cookie for standard scheme', async () => {
       let error
       try {
@@ -250,6 +293,68 @@ describe('session module', () => {
       expect(error).to.be.undefined(error)
     })
 
+    it('emits the filtered changes in one changes event when batching', async () => {
+      const batchInterval = 500
+      const { cookies } = session.fromPartition('cookies-changes')
+      const events = []
+      const listener = (event, list) => { events.push(list) }
+      cookies.setChangeNotificationOptions({ batch: true, batchInterval, names: ['kept'] })
+      cookies.on('changes', listener)
+      try {
+        const firstEvent = emittedOnce(cookies, 'changes')
+        await cookies.setMany([
+          { url, name: 'kept', value: 'one' },
+          { url, name: 'dropped', value: 'two' }
+        ])
+        await cookies.remove(url, 'kept')
+        await firstEvent
+        // Any change gathered separately would be emitted by now.
+        await new Promise(resolve => setTimeout(resolve, batchInterval * 2))
+
+        expect(events).to.have.lengthOf(1)
+        expect(events[0].map(change => change.cookie.name)).to.deep.equal(['kept', 'kept'])
+        expect(events[0].map(change => change.removed)).to.deep.equal([false, true])
+      } finally {
+        cookies.off('changes', listener)
+        cookies.setChangeNotificationOptions({})
+      }
+    })
+
+    it('only emits the changes of the filtered domains and their subdomains', async () => {
+      const batchInterval = 200
+      const { cookies } = session.fromPartition('cookies-changes-domains')
+      const changes = []
+      const listener = (event, list) => { changes.push(...list) }
+      // A host-only domain, and one given with a leading '.'.
+      cookies.setChangeNotificationOptions({ batch: true, batchInterval, domains: ['example.com', '.example.org'] })
+      cookies.on('changes', listener)
+      try {
+        const firstEvent = emittedOnce(cookies, 'changes')
+        await cookies.setMany([
+          // Host-only cookies of the domains.
+          { url: 'http://example.com', name: 'host-only', value: '1' },
+          { url: 'http://example.org', name: 'host-only-org', value: '1' },
+          // A cookie set for the domain and one of a subdomain.
+          { url: 'http://example.com', domain: '.example.com', name: 'domain', value: '1' },
+          { url: 'http://sub.example.com', name: 'subdomain', value: '1' },
+          // Domains that only end with the same characters, or are unrelated.
+          { url: 'http://notexample.com', name: 'suffix', value: '1' },
+          { url: 'http://example.net', name: 'other', value: '1' }
+        ])
+        await firstEvent
+        await new Promise(resolve => setTimeout(resolve, batchInterval * 2))
+
+        const names = changes.map(change => change.cookie.name).sort()
+        expect(names).to.deep.equal(['domain', 'host-only', 'host-only-org', 'subdomain'])
+        const hostOnly = changes.find(change => change.cookie.name === 'host-only')
+        expect(hostOnly.cookie.hostOnly).to.be.true()
+        expect(hostOnly.cookie.domain).to.equal('example.com')
+      } finally {
+        cookies.off('changes', listener)
+        cookies.setChangeNotificationOptions({})
+      }
+    })
+
     describe('ses.cookies.flushStore()', async () => {
       describe('flushes the cookies to disk and invokes the callback when done', async () => {
         it('with promises', async () => {
@@ -321,6 +426,143 @@ describe('session module', () => {
     })
   })
 
+  describe('ses.getDownloadsSnapshot()', () => {
+    it('returns an empty list when nothing is being downloaded', () => {
+      assert.deepStrictEqual(session.defaultSession.getDownloadsSnapshot(), [])
+    })
+  })
+
+  describe('ses.setCodeCacheSchemes(schemes)', () => {
+    const partition = 'persist:code-cache'
+    const cachePath = path.join(remote.app.getPath('userData'), 'Partitions',
+      'code-cache', 'Code Cache', 'node')
+    let ses = null
+    let win = null
+
+    beforeEach(() => {
+      ses = session.fromPartition(partition)
+    })
+
+    afterEach(() => {
+      ses.setCodeCacheSchemes([])
+      return closeWindow(win).then(() => { win = null })
+    })
+
+    it('rejects schemes that are not local', () => {
+      expect(() => ses.setCodeCacheSchemes(['https'])).to.throw(/privileged standard scheme/)
+      expect(ses.getCodeCacheSchemes()).to.deep.equal([])
+    })
+
+    it('keeps the code compiled for the preload script', async () => {
+      if (fs.existsSync(cachePath)) {
+        for (const entry of fs.readdirSync(cachePath)) {
+          fs.unlinkSync(path.join(cachePath, entry))
+        }
+      }
+      ses.setCodeCacheSchemes(['file'])
+      expect(ses.getCodeCacheSchemes()).to.deep.equal(['file'])
+
+      win = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          partition,
+          preload: path.join(fixtures, 'module', 'preload-code-cache.js')
+        }
+      })
+      const load = async () => {
+        const result = emittedOnce(ipcMain, 'code-cache-result')
+        await win.loadFile(path.join(fixtures, 'pages', 'a.html'))
+        const [, compileResult] = await result
+        return compileResult
+      }
+
+      const cold = await load()
+      expect(cold).to.deep.equal({ cachedData: false, cachedDataRejected: false })
+
+      while (!fs.existsSync(cachePath) || fs.readdirSync(cachePath).length === 0) {
+        await new Promise(resolve => setTimeout(resolve, 100))
+      }
+
+      const warm = await load()
+      expect(warm.cachedData).to.be.true()
+      expect(warm.cachedDataRejected).to.be.false()
+    })
+  })
+
+  describe('ses.setSpareRendererPool(options)', () => {
+    const partition = 'spare-renderer-pool'
+    let ses = null
+    let windows = []
+
+    const waitForSpares = async (count) => {
+      while (ses.getSpareRendererPids().length < count) {
+        await new Promise(resolve => setTimeout(resolve, 50))
+      }
+      return ses.getSpareRendererPids()
+    }
+
+    const openWindow = async (webPreferences) => {
+      const win = new BrowserWindow({
+        show: false,
+        webPreferences: Object.assign({ partition }, webPreferences)
+      })
+      windows.push(win)
+      const readyToShow = emittedOnce(win, 'ready-to-show')
+      win.loadFile(path.join(fixtures, 'pages', 'a.html'))
+      await readyToShow
+      return win
+    }
+
+    beforeEach(() => {
+      ses = session.fromPartition(partition)
+    })
+
+    afterEach(async () => {
+      ses.setSpareRendererPool({ size: 0 })
+      await Promise.all(windows.map(win => closeWindow(win, { assertSingleWindow: false })))
+      windows = []
+    })
+
+    it('hands a spare renderer to a window with the same webPreferences', async () => {
+      ses.setSpareRendererPool({ size: 1, webPreferences: { nodeIntegration: true } })
+      const [pid] = await waitForSpares(1)
+
+      const win = await openWindow({ nodeIntegration: true })
+      expect(win.webContents.getOSProcessId()).to.equal(pid)
+
+      const [refilled] = await waitForSpares(1)
+      expect(refilled).to.not.equal(pid)
+    })
+
+    it('does not hand a spare renderer to a window with other webPreferences', async () => {
+      ses.setSpareRendererPool({ size: 1, webPreferences: { nodeIntegration: true } })
+      const [pid] = await waitForSpares(1)
+
+      const win = await openWindow({ nodeIntegration: false })
+      expect(win.webContents.getOSProcessId()).to.not.equal(pid)
+      expect(ses.getSpareRendererPids()).to.deep.equal([pid])
+    })
+
+    it('shuts down the spare renderers when the pool is disabled', async () => {
+      ses.setSpareRendererPool({ size: 2 })
+      await waitForSpares(2)
+      ses.setSpareRendererPool({ size: 0 })
+      expect(ses.getSpareRendererPids()).to.deep.equal([])
+    })
+
+    it('relaunches a spare renderer that was killed', async () => {
+      ses.setSpareRendererPool({ size: 1 })
+      const [pid] = await waitForSpares(1)
+
+      process.kill(pid)
+      while (ses.getSpareRendererPids().includes(pid)) {
+        await new Promise(resolve => setTimeout(resolve, 50))
+      }
+      const [relaunched] = await waitForSpares(1)
+      expect(relaunched).to.not.equal(pid)
+    })
+  })
+
   describe('ses.clearStorageData(options)', () => {
     fixtures = path.resolve(__dirname, 'fixtures')
     it('clears localstorage data', (done) => {
@@ -483,6 +725,66 @@ describe('session module', () => {
       })
     })
 
+    it('limits how often updated is emitted with setUpdateInterval', (done) => {
+      const updateInterval = 300
+      const chunk = Buffer.alloc(64 * 1024)
+      const chunkCount = 20
+      // Sends the file over about a second, so it is updated many times.
+      const slowServer = http.createServer((req, res) => {
+        res.writeHead(200, {
+          'Content-Length': chunk.length * chunkCount,
+          'Content-Type': 'application/pdf',
+          'Content-Disposition': contentDisposition
+        })
+        let sent = 0
+        const timer = setInterval(() => {
+          res.write(chunk)
+          if (++sent === chunkCount) {
+            clearInterval(timer)
+            res.end()
+          }
+        }, 50)
+      })
+
+      const updateTimes = []
+      const onUpdated = (event, state, receivedBytes, time) => {
+        assert.strictEqual(state, 'progressing')
+        updateTimes.push(time)
+      }
+      ipcRenderer.on('download-updated', onUpdated)
+
+      slowServer.listen(0, '127.0.0.1', () => {
+        const port = slowServer.address().port
+        ipcRenderer.sendSync('set-download-option', false, false,
+          downloadFilePath, {}, updateInterval)
+        w.webContents.downloadURL(`${url}:${port}/`)
+        ipcRenderer.once('download-done', (event, state, url, mimeType,
+          receivedBytes, totalBytes) => {
+          slowServer.close()
+          assert.strictEqual(state, 'completed')
+          assert.strictEqual(receivedBytes, chunk.length * chunkCount)
+          assert.strictEqual(totalBytes, chunk.length * chunkCount)
+          fs.unlinkSync(downloadFilePath)
+
+          assert(updateTimes.length > 0)
+          assert(updateTimes.length < chunkCount, `${updateTimes.length} updates`)
+          for (let i = 1; i < updateTimes.length; i++) {
+            // Allow for the clocks of the timer and Date.now() to differ.
+            assert(updateTimes[i] - updateTimes[i - 1] >= updateInterval - 50,
+              `updates ${updateTimes[i] - updateTimes[i - 1]}ms apart`)
+          }
+
+          // A coalesced update must not arrive after the final state.
+          const updateCount = updateTimes.length
+          setTimeout(() => {
+            ipcRenderer.removeListener('download-updated', onUpdated)
+            assert.strictEqual(updateTimes.length, updateCount)
+            done()
+          }, updateInterval * 2)
+        })
+      })
+    })
+
     it('can cancel download', (done) => {
       downloadServer.listen(0, '127.0.0.1', () => {
         const port = downloadServer.address().port
@@ -693,6 +995,47 @@ describe('session module', () => {
         })
       })
     })
+
+    it('resolves multiple urls at once', (done) => {
+      const config = {
+        proxyRules: 'http=myproxy:80',
+        proxyBypassRules: '<local>'
+      }
+      customSession.setProxy(config, () => {
+        const urls = ['http://example.com/', 'http://example/', 'http://example.com/']
+        customSession.resolveProxies(urls, (proxies) => {
+          assert.deepStrictEqual(proxies, ['PROXY myproxy:80', 'DIRECT', 'PROXY myproxy:80'])
+          done()
+        })
+      })
+    })
+
+    it('does not reuse results across proxy settings changes', (done) => {
+      customSession.setMaxConcurrentProxyLookups(2)
+      customSession.setProxy({ proxyRules: 'http=myproxy:80' }, () => {
+        customSession.resolveProxy('http://example.com/', (proxy) => {
+          assert.strictEqual(proxy, 'PROXY myproxy:80')
+          customSession.setProxy({ proxyRules: 'http=otherproxy:80' }, () => {
+            customSession.resolveProxy('http://example.com/', (proxy) => {
+              assert.strictEqual(proxy, 'PROXY otherproxy:80')
+              done()
+            })
+          })
+        })
+      })
+    })
+
+    it('does not join lookups started before the proxy settings changed', (done) => {
+      customSession.setProxy({ proxyRules: 'http=myproxy:80' }, () => {
+        customSession.resolveProxy('http://example.com/', () => {})
+        customSession.setProxy({ proxyRules: 'http=otherproxy:80' }, () => {
+          customSession.resolveProxy('http://example.com/', (proxy) => {
+            assert.strictEqual(proxy, 'PROXY otherproxy:80')
+            done()
+          })
+        })
+      })
+    })
   })
 
   describe('ses.getBlobData(identifier, callback)', () => {
@@ -746,8 +1089,11 @@ describe('session module', () => {
 
   describe('ses.setCertificateVerifyProc(callback)', (done) => {
     let server = null
+    // A server with the same certificate on another port, a load from it can
+    // not reuse a connection or TLS session to |server| and is verified again.
+    let otherServer = null
 
-    beforeEach((done) => {
+    const createServer = (done) => {
       const certPath = path.join(__dirname, 'fixtures', 'certificates')
       const options = {
         key: fs.readFileSync(path.join(certPath, 'server.key')),
@@ -760,16 +1106,24 @@ describe('session module', () => {
         rejectUnauthorized: false
       }
 
-      server = https.createServer(options, (req, res) => {
+      const httpsServer = https.createServer(options, (req, res) => {
         res.writeHead(200)
         res.end('<title>hello</title>')
       })
-      server.listen(0, '127.0.0.1', done)
+      httpsServer.listen(0, '127.0.0.1', done)
+      return httpsServer
+    }
+
+    beforeEach((done) => {
+      server = createServer(() => {
+        otherServer = createServer(done)
+      })
     })
 
     afterEach(() => {
       session.defaultSession.setCertificateVerifyProc(null)
       server.close()
+      otherServer.close()
     })
 
     it('accepts the request when the callback is called with 0', (done) => {
@@ -809,6 +1163,88 @@ describe('session module', () => {
       })
       w.loadURL(url)
     })
+
+    it('calls the proc again for results that are not cacheable', (done) => {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc((request, callback) => {
+        calls++
+        callback(0)
+      })
+
+      w.webContents.once('did-finish-load', () => {
+        assert.strictEqual(calls, 1)
+        w.webContents.once('did-finish-load', () => {
+          assert.strictEqual(w.webContents.getTitle(), 'hello')
+          assert.strictEqual(calls, 2)
+          done()
+        })
+        w.loadURL(`https://127.0.0.1:${otherServer.address().port}`)
+      })
+      w.loadURL(`https://127.0.0.1:${server.address().port}`)
+    })
+
+    it('reuses results passed with the cacheable option', (done) => {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc((request, callback) => {
+        calls++
+        callback(0, { cacheable: true, maxAge: 600 })
+      })
+
+      w.webContents.once('did-finish-load', () => {
+        assert.strictEqual(w.webContents.getTitle(), 'hello')
+        w.webContents.once('did-finish-load', () => {
+          assert.strictEqual(w.webContents.getTitle(), 'hello')
+          assert.strictEqual(calls, 1)
+          done()
+        })
+        w.loadURL(`https://127.0.0.1:${otherServer.address().port}`)
+      })
+      w.loadURL(`https://127.0.0.1:${server.address().port}`)
+    })
+
+    it('can clear the cached results', (done) => {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc((request, callback) => {
+        calls++
+        callback(0, { cacheable: true })
+      })
+
+      w.webContents.once('did-finish-load', () => {
+        assert.strictEqual(calls, 1)
+        session.defaultSession.clearCertificateVerifyCache(() => {
+          w.webContents.once('did-finish-load', () => {
+            assert.strictEqual(w.webContents.getTitle(), 'hello')
+            assert.strictEqual(calls, 2)
+            done()
+          })
+          w.loadURL(`https://127.0.0.1:${otherServer.address().port}`)
+        })
+      })
+      w.loadURL(`https://127.0.0.1:${server.address().port}`)
+    })
+
+    it('does not cache results of a proc replaced while verifying', (done) => {
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc((request, callback) => {
+        // Answer only after the proc has been replaced.
+        session.defaultSession.setCertificateVerifyProc((request, callback) => {
+          calls++
+          callback(0)
+        })
+        setTimeout(() => callback(0, { cacheable: true, maxAge: 600 }), 100)
+      })
+
+      w.webContents.once('did-finish-load', () => {
+        assert.strictEqual(calls, 0)
+        w.webContents.once('did-finish-load', () => {
+          assert.strictEqual(w.webContents.getTitle(), 'hello')
+          assert.strictEqual(calls, 1)
+          done()
+        })
+        w.loadURL(`https://127.0.0.1:${otherServer.address().port}`)
+      })
+      w.loadURL(`https://127.0.0.1:${server.address().port}`)
+    })
   })
 
   describe('ses.createInterruptedDownload(options)', () => {
@@ -958,5 +1394,68 @@ describe('session module', () => {
       webview.setAttribute('nodeintegration', 'on')
       document.body.appendChild(webview)
     })
+
+    it('reuses cached decisions until they are cleared', (done) => {
+      const ses = session.fromPartition('permissionCacheTest')
+      let handlerCalls = 0
+      ses.setPermissionRequestHandler((webContents, permission, callback) => {
+        handlerCalls++
+        callback({ granted: false, cache: true })
+      })
+
+      let loads = 0
+      webview = new WebView()
+      webview.addEventListener('ipc-message', (e) => {
+        assert.strictEqual(e.channel, 'message')
+        assert.deepStrictEqual(e.args, ['SecurityError'])
+        loads++
+        if (loads === 1) {
+          webview.reload()
+        } else if (loads === 2) {
+          assert.strictEqual(handlerCalls, 1)
+          ses.clearPermissionDecisions()
+          webview.reload()
+        } else {
+          assert.strictEqual(handlerCalls, 2)
+          ses.setPermissionRequestHandler(null)
+          done()
+        }
+      })
+      webview.src = `file://${fixtures}/pages/permissions/midi-sysex.html`
+      webview.partition = 'permissionCacheTest'
+      webview.setAttribute('nodeintegration', 'on')
+      document.body.appendChild(webview)
+    })
+
+    it('reuses cached check decisions only for the same details', async () => {
+      const partition = 'permissionCheckCacheTest'
+      const ses = session.fromPartition(partition)
+      const mediaTypes = []
+      ses.setPermissionCheckHandler((webContents, permission, requestingOrigin, details) => {
+        mediaTypes.push(details.mediaType)
+        return { granted: false, cache: true }
+      })
+
+      const w = new BrowserWindow({ show: false, webPreferences: { partition } })
+      try {
+        await w.loadFile(path.join(fixtures, 'api', 'blank.html'))
+        const enumerate = 'navigator.mediaDevices.enumerateDevices().then(devices => devices.length)'
+        await w.webContents.executeJavaScript(enumerate)
+        const firstChecks = mediaTypes.slice()
+        expect(firstChecks).to.not.be.empty()
+        // A denial for one media type does not answer the checks of another.
+        expect(new Set(firstChecks).size).to.equal(firstChecks.length)
+
+        await w.webContents.executeJavaScript(enumerate)
+        expect(mediaTypes).to.deep.equal(firstChecks)
+
+        ses.clearPermissionDecisions()
+        await w.webContents.executeJavaScript(enumerate)
+        expect(mediaTypes).to.deep.equal([...firstChecks, ...firstChecks])
+      } finally {
+        ses.setPermissionCheckHandler(null)
+        await closeWindow(w)
+      }
+    })
   })
 })
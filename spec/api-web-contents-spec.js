@@ -6,7 +6,7 @@ const fs = require('fs')
 const http = require('http')
 const path = require('path')
 const { closeWindow } = require('./window-helpers')
-const { emittedOnce } = require('./events-helpers')
+const { emittedNTimes, emittedOnce } = require('./events-helpers')
 const chai = require('chai')
 const dirtyChai = require('dirty-chai')
 
@@ -998,6 +998,214 @@ describe('webContents module', () => {
     })
   })
 
+  describe('webContents.broadcast()', () => {
+    const windows = []
+
+    afterEach(async () => {
+      await Promise.all(windows.map(win => closeWindow(win, { assertSingleWindow: false })))
+      windows.length = 0
+    })
+
+    it('delivers the same message to every target', async () => {
+      for (let i = 0; i < 3; i++) {
+        windows.push(new BrowserWindow({
+          show: false,
+          webPreferences: {
+            preload: path.join(fixtures, 'module', 'preload-ipc-echo.js')
+          }
+        }))
+      }
+      await Promise.all(windows.map(win => win.loadURL('about:blank')))
+
+      const replies = windows.map(win => emittedOnce(win.webContents, 'ipc-message'))
+      const sent = webContents.broadcast(windows.map(win => win.webContents), 'echo', { tick: 1 }, 'a')
+      expect(sent).to.equal(3)
+
+      for (const [, channel, ...args] of await Promise.all(replies)) {
+        expect(channel).to.equal('echo-reply')
+        expect(args).to.deep.equal([{ tick: 1 }, 'a'])
+      }
+    })
+
+    it('accepts frame targets and skips missing frames', async () => {
+      const win = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          preload: path.join(fixtures, 'module', 'preload-ipc-echo.js')
+        }
+      })
+      windows.push(win)
+      await win.loadURL('about:blank')
+
+      const reply = emittedOnce(win.webContents, 'ipc-message')
+      const sent = webContents.broadcast([
+        { webContents: win.webContents },
+        { webContents: win.webContents, frameId: 0x7fffffff }
+      ], 'echo', 'frame')
+      expect(sent).to.equal(1)
+
+      const [, , ...args] = await reply
+      expect(args).to.deep.equal(['frame'])
+    })
+
+    it('throws when the targets are not an array', () => {
+      expect(() => webContents.broadcast(w.webContents, 'echo')).to.throw(/targets/)
+    })
+
+    it('delivers to the subframes with broadcastToAll', async () => {
+      const win = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          preload: path.join(fixtures, 'module', 'preload-ipc-echo.js'),
+          nodeIntegrationInSubFrames: true
+        }
+      })
+      windows.push(win)
+      await win.loadFile(path.join(fixtures, 'sub-frames', 'frame-container.html'))
+
+      const replies = emittedNTimes(win.webContents, 'ipc-message', 2)
+      const sent = webContents.broadcastToAll([win.webContents], 'echo', { tick: 2 })
+      expect(sent).to.equal(1)
+
+      for (const [, channel, ...args] of await replies) {
+        expect(channel).to.equal('echo-reply')
+        expect(args).to.deep.equal([{ tick: 2 }])
+      }
+    })
+
+    it('only delivers to the targeted frames with broadcast', async () => {
+      const win = new BrowserWindow({
+        show: false,
+        webPreferences: {
+          preload: path.join(fixtures, 'module', 'preload-ipc-echo.js'),
+          nodeIntegrationInSubFrames: true
+        }
+      })
+      windows.push(win)
+      await win.loadFile(path.join(fixtures, 'sub-frames', 'frame-container.html'))
+
+      let replies = 0
+      win.webContents.on('ipc-message', () => { replies++ })
+      webContents.broadcast([win.webContents], 'echo', 'main')
+      await new Promise(resolve => setTimeout(resolve, 500))
+      expect(replies).to.equal(1)
+    })
+  })
+
+  describe('webContents.createDirectChannel()', () => {
+    let first, second
+
+    beforeEach(async () => {
+      const options = {
+        show: false,
+        webPreferences: {
+          preload: path.join(fixtures, 'module', 'preload-direct-channel.js')
+        }
+      }
+      first = new BrowserWindow(options)
+      second = new BrowserWindow(options)
+      await Promise.all([first.loadURL('about:blank'), second.loadURL('about:blank')])
+    })
+
+    afterEach(async () => {
+      await Promise.all([first, second].map(win => closeWindow(win, { assertSingleWindow: false })))
+      first = second = null
+    })
+
+    it('relays messages between the two frames', async () => {
+      const channelId = webContents.createDirectChannel(first.webContents, second.webContents)
+      const pong = emittedOnce(second.webContents, 'ipc-message')
+      first.webContents.send('direct-send', channelId, { hello: 'world' })
+
+      const [, channel, senderId, payload] = await pong
+      expect(channel).to.equal('direct-pong')
+      expect(senderId).to.equal(first.webContents.id)
+      expect(payload).to.deep.equal({ hello: 'world' })
+    })
+
+    it('stops relaying once the channel is closed', async () => {
+      const channelId = webContents.createDirectChannel(first.webContents, second.webContents)
+      webContents.closeDirectChannel(channelId)
+
+      let received = false
+      second.webContents.once('ipc-message', () => { received = true })
+      first.webContents.send('direct-send', channelId, 'dropped')
+      await new Promise(resolve => setTimeout(resolve, 500))
+      expect(received).to.be.false()
+    })
+
+    it('stops relaying once an endpoint navigates', async () => {
+      const channelId = webContents.createDirectChannel(first.webContents, second.webContents)
+      await second.loadURL('about:blank')
+
+      let received = false
+      second.webContents.once('ipc-message', () => { received = true })
+      first.webContents.send('direct-send', channelId, 'dropped')
+      await new Promise(resolve => setTimeout(resolve, 500))
+      expect(received).to.be.false()
+    })
+
+    it('relays messages while the main thread is busy', async () => {
+      const channelId = webContents.createDirectChannel(remote.getCurrentWebContents(), first.webContents)
+      const events = []
+      const reply = new Promise(resolve => {
+        ipcRenderer.once('direct-reply', (event, payload) => {
+          events.push('reply')
+          resolve(payload)
+        })
+      })
+      const unblocked = new Promise(resolve => {
+        ipcRenderer.once('main-thread-unblocked', () => {
+          events.push('unblocked')
+          resolve()
+        })
+      })
+
+      const blocked = emittedOnce(ipcRenderer, 'main-thread-blocked')
+      ipcRenderer.send('block-main-thread', 2000)
+      await blocked
+      ipcRenderer.sendDirect(channelId, 'direct-ping', 'busy', channelId)
+
+      expect(await reply).to.equal('busy')
+      await unblocked
+      webContents.closeDirectChannel(channelId)
+      expect(events).to.deep.equal(['reply', 'unblocked'])
+    })
+
+    it('relays messages between sandboxed frames', async () => {
+      // The sandboxed renderers get ipcRenderer.sendDirect from the same
+      // module and native binding as the other renderers.
+      const options = {
+        show: false,
+        webPreferences: {
+          sandbox: true,
+          preload: path.join(fixtures, 'module', 'preload-direct-channel.js')
+        }
+      }
+      const sandboxedFirst = new BrowserWindow(options)
+      const sandboxedSecond = new BrowserWindow(options)
+      try {
+        await Promise.all([sandboxedFirst.loadURL('about:blank'), sandboxedSecond.loadURL('about:blank')])
+        const channelId = webContents.createDirectChannel(sandboxedFirst.webContents, sandboxedSecond.webContents)
+        const pong = emittedOnce(sandboxedSecond.webContents, 'ipc-message')
+        sandboxedFirst.webContents.send('direct-send', channelId, { hello: 'sandbox' })
+
+        const [, channel, senderId, payload] = await pong
+        expect(channel).to.equal('direct-pong')
+        expect(senderId).to.equal(sandboxedFirst.webContents.id)
+        expect(payload).to.deep.equal({ hello: 'sandbox' })
+      } finally {
+        await Promise.all([sandboxedFirst, sandboxedSecond].map(win => closeWindow(win, { assertSingleWindow: false })))
+      }
+    })
+
+    it('throws for frames that do not exist', () => {
+      expect(() => {
+        webContents.createDirectChannel(first.webContents, { webContents: second.webContents, frameId: 0x7fffffff })
+      }).to.throw(/live frame/)
+    })
+  })
+
   describe('ipc-message event', () => {
     it('emits when the renderer process sends an asynchronous message', async () => {
       const webContents = remote.getCurrentWebContents()
@@ -1191,6 +1399,21 @@ describe('webContents module', () => {
       }
     })
 
+    it('can compress the snapshot with gzip', async () => {
+      await w.loadURL('about:blank')
+
+      const filePath = path.join(remote.app.getPath('temp'), 'test.heapsnapshot.gz')
+
+      try {
+        const { bytesWritten } = await w.webContents.takeHeapSnapshot(filePath, { gzip: true })
+        const compressed = fs.readFileSync(filePath)
+        expect(compressed.length).to.equal(bytesWritten)
+        JSON.parse(require('zlib').gunzipSync(compressed).toString())
+      } finally {
+        fs.unlinkSync(filePath)
+      }
+    })
+
     it('fails with invalid file path', async () => {
       w.destroy()
       w = new BrowserWindow({
@@ -959,6 +959,38 @@ describe('asar package', function () {
         const p = path.join(fixtures, 'asar', 'unpack.asar', 'a.txt')
         assert.strictEqual(internalModuleReadJSON(p).toString().trim(), 'a')
       })
+
+      it('returns undefined for missing files', function () {
+        const p = path.join(fixtures, 'asar', 'a.asar', 'not-exist')
+        assert.strictEqual(internalModuleReadJSON(p), undefined)
+        // The second lookup is answered by the cache of missing paths.
+        assert.strictEqual(internalModuleReadJSON(p), undefined)
+      })
+    })
+
+    describe('internalModuleStat', function () {
+      const internalModuleStat = process.binding('fs').internalModuleStat
+
+      it('returns 0 for files and 1 for directories', function () {
+        assert.strictEqual(internalModuleStat(path.join(fixtures, 'asar', 'a.asar', 'file1')), 0)
+        assert.strictEqual(internalModuleStat(path.join(fixtures, 'asar', 'a.asar', 'dir1')), 1)
+        assert.strictEqual(internalModuleStat(path.join(fixtures, 'asar', 'a.asar')), 1)
+      })
+
+      it('returns an error for missing files', function () {
+        const p = path.join(fixtures, 'asar', 'a.asar', 'not-exist')
+        assert.strictEqual(internalModuleStat(p), -34)
+        assert.strictEqual(internalModuleStat(p), -34)
+      })
+
+      it('handles paths which are not normalized', function () {
+        const p = `${path.join(fixtures, 'asar', 'a.asar', 'dir1')}${path.sep}..${path.sep}file1`
+        assert.strictEqual(internalModuleStat(p), 0)
+      })
+
+      it('handles paths outside archives', function () {
+        assert.strictEqual(internalModuleStat(path.join(fixtures, 'asar')), 1)
+      })
     })
 
     describe('util.promisify', function () {
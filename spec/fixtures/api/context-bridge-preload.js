@@ -0,0 +1,22 @@
+const { contextBridge } = require('electron')
+
+const shared = { value: 'shared' }
+
+contextBridge.exposeInMainWorld('bridge', {
+  name: 'bridge',
+  nested: { list: [1, 'two', { three: 3 }] },
+  first: shared,
+  second: shared,
+  bytes: new Uint8Array([1, 2, 3]),
+  add: (a, b) => a + b,
+  call: (callback) => callback('isolated'),
+  resolve: (value) => Promise.resolve(value),
+  fail: () => { throw new Error('isolated failure') },
+  typeofRequire: () => typeof require,
+  throwingGetter: () => ({ get value () { throw new Error('isolated getter') } }),
+  throwingObject: () => {
+    // eslint-disable-next-line no-throw-literal
+    throw { get message () { throw new Error('isolated getter') } }
+  },
+  resolveThrowingGetter: () => Promise.resolve({ get value () { throw new Error('isolated getter') } })
+})
@@ -0,0 +1,16 @@
+const { app } = require('electron')
+
+app.once('ready', () => {
+  console.log('started') // ping parent
+})
+
+const gotTheLock = app.requestSingleInstanceLock()
+
+app.on('second-instance', (event, argv) => {
+  console.log(JSON.stringify(argv))
+  setImmediate(() => app.exit(0))
+})
+
+if (!gotTheLock) {
+  app.exit(1)
+}
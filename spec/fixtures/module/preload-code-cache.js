@@ -0,0 +1,4 @@
+const { ipcRenderer } = require('electron')
+const { getCompileResult } = require('@electron/internal/renderer/code-cache')
+
+ipcRenderer.send('code-cache-result', getCompileResult(__filename))
@@ -0,0 +1,14 @@
+const { ipcRenderer } = require('electron')
+
+ipcRenderer.on('direct-send', function (event, channelId, payload) {
+  ipcRenderer.sendDirect(channelId, 'direct-ping', payload)
+})
+
+ipcRenderer.on('direct-ping', function (event, payload, replyChannelId) {
+  if (replyChannelId) {
+    // Answers without going through the main process.
+    ipcRenderer.sendDirect(replyChannelId, 'direct-reply', payload)
+  } else {
+    ipcRenderer.send('direct-pong', event.senderId, payload)
+  }
+})
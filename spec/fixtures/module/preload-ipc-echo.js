@@ -0,0 +1,5 @@
+const { ipcRenderer } = require('electron')
+
+ipcRenderer.on('echo', function (event, ...args) {
+  ipcRenderer.send('echo-reply', ...args)
+})
@@ -0,0 +1,46 @@
+const v8Util = process.atomBinding('v8_util')
+
+const objects = []
+const shared = { index: -1 }
+let dereferenceMessages = 0
+
+const countDereference = function (event, internal, channel) {
+  if (internal && channel === 'ELECTRON_BROWSER_DEREFERENCE') {
+    dereferenceMessages++
+  }
+}
+
+exports.create = function (count) {
+  const created = []
+  for (let i = 0; i < count; i++) {
+    const object = { index: i }
+    objects.push(object)
+    created.push(object)
+  }
+  return created
+}
+
+exports.getShared = function () {
+  return shared
+}
+
+// Objects held by a renderer are tagged with an 'atomId' by the objects
+// registry until the renderer releases them.
+exports.countReferenced = function () {
+  return objects.filter(object => v8Util.getHiddenValue(object, 'atomId') != null).length
+}
+
+exports.isSharedReferenced = function () {
+  return v8Util.getHiddenValue(shared, 'atomId') != null
+}
+
+// Counts the messages |contents| sends to release remote objects.
+exports.watchDereferences = function (contents) {
+  dereferenceMessages = 0
+  contents.on('-ipc-message', countDereference)
+}
+
+exports.unwatchDereferences = function (contents) {
+  contents.removeListener('-ipc-message', countDereference)
+  return dereferenceMessages
+}
@@ -76,6 +76,17 @@ ipcMain.on('echo', function (event, msg) {
   event.returnValue = msg
 })
 
+// Keeps the main thread busy for |duration| ms, telling the sender when it
+// starts and when it is done.
+ipcMain.on('block-main-thread', function (event, duration) {
+  event.sender.send('main-thread-blocked')
+  const end = Date.now() + duration
+  while (Date.now() < end) {
+    // Busy.
+  }
+  event.sender.send('main-thread-unblocked')
+})
+
 global.setTimeoutPromisified = util.promisify(setTimeout)
 
 global.permissionChecks = {
@@ -159,7 +170,7 @@ app.on('ready', function () {
   // For session's download test, listen 'will-download' event in browser, and
   // reply the result to renderer for verifying
   const downloadFilePath = path.join(__dirname, '..', 'fixtures', 'mock.pdf')
-  ipcMain.on('set-download-option', function (event, needCancel, preventDefault, filePath = downloadFilePath, dialogOptions = {}) {
+  ipcMain.on('set-download-option', function (event, needCancel, preventDefault, filePath = downloadFilePath, dialogOptions = {}, updateInterval = 0) {
     window.webContents.session.once('will-download', function (e, item) {
       window.webContents.send('download-created',
         item.getState(),
@@ -187,6 +198,13 @@ app.on('ready', function () {
           item.setSavePath(filePath)
           item.setSaveDialogOptions(dialogOptions)
         }
+        item.setUpdateInterval(updateInterval)
+        item.on('updated', function (e, state) {
+          window.webContents.send('download-updated',
+            state,
+            item.getReceivedBytes(),
+            Date.now())
+        })
         item.on('done', function (e, state) {
           window.webContents.send('download-done',
             state,